@@ -4,15 +4,17 @@
 #include <shared/Matrix.h>
 #include <shared/path_utils/PermutationPath.h>
 
-#include <algorithm>  // std::fill_n
-#include <chrono>     // std::chrono::milliseconds
-#include <memory>     // std::unique_ptr, std::make_unique
-#include <optional>   // std::optional
-#include <queue>      // std::deque
-#include <sstream>    // std::stringstream
-#include <thread>     // std::thread::hardware_concurrency
-#include <utility>    // std::pair
-#include <vector>     // std::vector
+#include <algorithm>    // std::fill_n
+#include <chrono>       // std::chrono::milliseconds
+#include <cmath>        // std::llround
+#include <memory>       // std::unique_ptr, std::make_unique
+#include <optional>     // std::optional
+#include <queue>        // std::deque
+#include <sstream>      // std::stringstream
+#include <thread>       // std::thread::hardware_concurrency
+#include <type_traits>  // std::is_integral_v
+#include <utility>      // std::pair
+#include <vector>       // std::vector
 
 #include "cpx_macro.h"
 
@@ -352,7 +354,13 @@ inline std::optional<PermutationPath<T>> CPLEXModel<T>::get_solution() const {
         // Compute permutation path with preset distance
         PermutationPath<T> permutation_path(this->retrieve_path(std::move(variable_values)),
                                             this->distance_matrix);
-        permutation_path.reset_cost(objective_value);
+
+        // integral costs are rounded, since CPLEX returns an approximation of the objective value
+        if constexpr (std::is_integral_v<typename PermutationPath<T>::cost_t>) {
+            permutation_path.reset_cost(std::llround(objective_value));
+        } else {
+            permutation_path.reset_cost(objective_value);
+        }
 
         return {permutation_path};
     } catch (std::exception& e) {
@@ -13,6 +13,10 @@ namespace cli {
 
         bool& show_path = flag("s,show-path", "Show the path of the solution").set_default(false);
 
+        std::string& distance_type =
+            kwarg("d,distance-type", "Type of the distances: double, int32, uint16")
+                .set_default("double");
+
         // Show introductory message to the users
         void welcome() override {
             std::cout << "CPLEX MILP solver\n";
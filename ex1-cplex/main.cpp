@@ -3,6 +3,7 @@
 #include <optional>  // std::optional
 
 #include <shared/DistanceMatrix.h>
+#include <shared/DistanceType.h>
 #include <shared/read_tsp_file.h>
 #include <shared/stopwatch.h>
 #include <shared/path_utils/PermutationPath.h>
@@ -10,22 +11,18 @@
 #include "cli.h"
 #include "CPLEXModel.h"
 
-int main(int argc, char** argv) {
-    /**
-     * Handler for command-line arguments
-     */
-    auto args = cli::parse(argc, argv);
+// Solve the TSP instance read by point_reader, using distances of type T
+template <typename T>
+void run(const cli::CLIArgs& args, point_reader::PointReader& point_reader) {
     std::chrono::duration timeout_ms = std::chrono::milliseconds(args.timeout_ms);
 
-    auto point_reader(read_tsp_file(args.filename.c_str()));
-
-    const size_t N = point_reader->dimension;
-    DistanceMatrix<double> distance_matrix = point_reader->create_distance_matrix();
+    const size_t N = point_reader.dimension;
+    DistanceMatrix<T> distance_matrix = point_reader.create_distance_matrix<T>();
 
     // start the stopwatch
     const auto program_time_start = stopwatch::now();
 
-    CPLEXModel<double> cplex_model(distance_matrix, timeout_ms);
+    CPLEXModel<T> cplex_model(distance_matrix, timeout_ms);
 
     cplex_model.solve();
 
@@ -42,7 +39,7 @@ int main(int argc, char** argv) {
     std::cout << "program_time_ms: " << program_time_ms << '\n';
     std::cout << "was_interrupted: " << was_interrupted << '\n';
 
-    std::optional<PermutationPath<double>> solution_path = cplex_model.get_solution();
+    std::optional<PermutationPath<T>> solution_path = cplex_model.get_solution();
 
     if (solution_path.has_value()) {
         std::cout << "solution_cost: " << std::fixed << solution_path->cost() << '\n';
@@ -57,5 +54,19 @@ int main(int argc, char** argv) {
     }
 
     std::cout << std::flush;
+}
+
+int main(int argc, char** argv) {
+    /**
+     * Handler for command-line arguments
+     */
+    auto args = cli::parse(argc, argv);
+
+    auto point_reader(read_tsp_file(args.filename.c_str()));
+
+    // instantiate the model with the distance type chosen by the user
+    visit_distance_type(parse_distance_type(args.distance_type),
+                        [&](auto distance) { run<decltype(distance)>(args, *point_reader); });
+
     return 0;
 }
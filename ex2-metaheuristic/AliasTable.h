@@ -0,0 +1,103 @@
+#pragma once
+
+#include <iterator>  // std::distance
+#include <random>    // std::uniform_int_distribution, std::uniform_real_distribution
+#include <vector>    // std::vector
+
+/**
+ * AliasTable is Walker's alias table of a discrete distribution over the outcomes [0, n). It's
+ * built in O(n) with Vose's algorithm, and it samples an outcome in O(1) with one uniform index
+ * and one uniform probability, without allocating memory.
+ * Each outcome i owns a slot, which returns i with probability threshold[i] and alias[i]
+ * otherwise.
+ * See: https://www.keithschwarz.com/darts-dice-coins/
+ */
+class AliasTable {
+    // threshold[i] is the probability that the i-th slot returns i
+    std::vector<double> threshold;
+
+    // alias[i] is the outcome returned by the i-th slot when it doesn't return i
+    std::vector<size_t> alias;
+
+public:
+    // Build the table of the distribution whose weights are in the range [first, last). The
+    // weights don't need to be normalized, but they can't be all zero.
+    template <class ForwardIt>
+    AliasTable(ForwardIt first, ForwardIt last) :
+        threshold(std::distance(first, last)), alias(threshold.size()) {
+        const size_t n = threshold.size();
+
+        double sum = 0.0;
+        for (auto it = first; it != last; ++it) {
+            sum += *it;
+        }
+
+        // the weights are scaled so that their average is 1
+        std::vector<double> scaled;
+        scaled.reserve(n);
+        for (auto it = first; it != last; ++it) {
+            scaled.push_back(*it * n / sum);
+        }
+
+        // outcomes whose scaled weight is less than 1 or at least 1, respectively
+        std::vector<size_t> small;
+        std::vector<size_t> large;
+        for (size_t i = 0; i < n; ++i) {
+            if (scaled[i] < 1.0) {
+                small.push_back(i);
+            } else {
+                large.push_back(i);
+            }
+        }
+
+        // fill the slot of each small outcome with the excess of a large one
+        while (!small.empty() && !large.empty()) {
+            const size_t l = small.back();
+            small.pop_back();
+            const size_t g = large.back();
+            large.pop_back();
+
+            this->threshold[l] = scaled[l];
+            this->alias[l] = g;
+
+            scaled[g] = (scaled[g] + scaled[l]) - 1.0;
+            if (scaled[g] < 1.0) {
+                small.push_back(g);
+            } else {
+                large.push_back(g);
+            }
+        }
+
+        // the outcomes left are the ones whose scaled weight is 1 up to rounding errors
+        for (size_t i : large) {
+            this->threshold[i] = 1.0;
+            this->alias[i] = i;
+        }
+
+        for (size_t i : small) {
+            this->threshold[i] = 1.0;
+            this->alias[i] = i;
+        }
+    }
+
+    // Return the number of outcomes
+    [[nodiscard]] size_t size() const noexcept {
+        return this->threshold.size();
+    }
+
+    // Sample an outcome in [0, n) in O(1)
+    template <class URBG>
+    [[nodiscard]] size_t operator()(URBG&& random_generator) const noexcept {
+        using index_distr_t = std::uniform_int_distribution<size_t>;
+        using index_param_t = typename index_distr_t::param_type;
+        using real_distr_t = std::uniform_real_distribution<double>;
+        using real_param_t = typename real_distr_t::param_type;
+        index_distr_t index_distribution;
+        real_distr_t real_distribution;
+
+        const size_t i = index_distribution(random_generator, index_param_t(0, this->size() - 1));
+        const double u = real_distribution(random_generator, real_param_t(0, 1));
+
+        return u < this->threshold[i] ? i : this->alias[i];
+    }
+};
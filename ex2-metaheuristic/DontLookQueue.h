@@ -0,0 +1,52 @@
+#pragma once
+
+#include <vector>  // std::vector
+
+/**
+ * FIFO queue of the cities whose don't-look bit is off, i.e. the cities that a local search
+ * should still try to improve. A city can appear in the queue at most once.
+ * It's stored as a ring buffer allocated once, and reused across local search runs.
+ */
+class DontLookQueue {
+    std::vector<size_t> queue;
+    size_t head = 0;
+    size_t count = 0;
+
+    // in_queue[city] is true iff the don't-look bit of city is off
+    std::vector<bool> in_queue;
+
+public:
+    explicit DontLookQueue(size_t n) : queue(n), in_queue(n, false) {
+    }
+
+    // Return true iff there are no cities left to look at
+    [[nodiscard]] bool empty() const noexcept {
+        return this->count == 0;
+    }
+
+    // Turn off the don't-look bit of the given city
+    void push(size_t city) noexcept {
+        if (!this->in_queue[city]) {
+            this->queue[(this->head + this->count) % this->queue.size()] = city;
+            ++this->count;
+            this->in_queue[city] = true;
+        }
+    }
+
+    // Extract the next city to look at and turn on its don't-look bit
+    size_t pop() noexcept {
+        const size_t city = this->queue[this->head];
+        this->head = (this->head + 1) % this->queue.size();
+        --this->count;
+        this->in_queue[city] = false;
+        return city;
+    }
+
+    // Turn off the don't-look bits of the given range of cities
+    template <class InputIt>
+    void push(InputIt first, InputIt last) noexcept {
+        for (auto it = first; it != last; ++it) {
+            this->push(*it);
+        }
+    }
+};
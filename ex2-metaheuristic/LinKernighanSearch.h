@@ -0,0 +1,281 @@
+#pragma once
+
+#include <shared/NeighborLists.h>
+#include <shared/path_utils/PermutationPath.h>
+
+#include <algorithm>  // std::find
+#include <iterator>   // std::size
+#include <utility>    // std::pair
+#include <vector>     // std::vector
+
+#include "DontLookQueue.h"
+#include "TourIndex.h"
+#include "utils.h"
+
+/**
+ * Lin-Kernighan style variable-depth local search.
+ * Starting from an edge (t1, t2), it builds a chain of sequential 2-opt moves (or2opt): at each
+ * step the edge (t2, t3) is added, where t3 is a nearest neighbor of t2, the edge (t4, t3) with
+ * t4 = prev(t3) is removed, and the circuit is temporarily closed with (t4, t1).
+ * At the first level, t4 = next(t3) is tried as well. Closing with (t4, t1) would split the
+ * circuit, so the edge (t5, t6) is removed too, where t5 is a nearest neighbor of t4 between t2
+ * and t3 and t6 = next(t5), and (t4, t5), (t6, t1) are added. This is the pure sequential 3-opt
+ * move (or3opt), which swaps the adjacent segments t2..t5 and t6..t3 without reversing them.
+ * The chain is extended while its partial gain stays positive, up to a bounded depth; the
+ * prefix with the best closed gain is kept, and the rest is undone.
+ * The first levels try several alternatives for t3, the deeper ones only the first.
+ * Its buffers are allocated once and reused for every path it improves.
+ */
+template <typename T, typename Index>
+class LinKernighanSearch {
+    using cost_t = typename PermutationPath<T, Index>::cost_t;
+    using edge_t = std::pair<size_t, size_t>;
+
+    // Maximum number of levels of a chain. An or3opt move takes the first 2 levels.
+    static constexpr size_t MAX_DEPTH = 6;
+
+    // Maximum number of flips applied by a chain. An or3opt move takes 3 flips.
+    static constexpr size_t MAX_FLIPS = MAX_DEPTH + 1;
+
+    // Number of alternatives for t3 (or t5) considered at the first levels of the chain
+    static constexpr size_t BREADTH[] = {5, 3};
+
+    // Constant reference to the candidate lists of each city
+    const NeighborLists& neighbor_lists;
+
+    // Position index of the path being improved
+    TourIndex<T, Index> tour;
+
+    // Cities whose don't-look bit is off
+    DontLookQueue queue;
+
+    // Flips applied by the current chain, i.e. the reversed subpaths (from, to)
+    std::vector<edge_t> flips;
+
+    // Edges added by the current chain. They can't be removed by the same chain.
+    std::vector<edge_t> added_edges;
+
+    // Cities touched by the current chain
+    std::vector<size_t> touched;
+
+    // Best closed gain of the current chain, and the number of flips that obtain it
+    cost_t best_gain = 0;
+    size_t best_depth = 0;
+
+    [[nodiscard]] bool is_added_edge(size_t a, size_t b) const noexcept {
+        return std::find(this->added_edges.cbegin(), this->added_edges.cend(), edge_t{a, b}) !=
+                   this->added_edges.cend() ||
+               std::find(this->added_edges.cbegin(), this->added_edges.cend(), edge_t{b, a}) !=
+                   this->added_edges.cend();
+    }
+
+    // Apply the flip (from, to) as part of the current chain
+    void push_flip(size_t from, size_t to) noexcept {
+        this->tour.flip(from, to);
+        this->flips.emplace_back(from, to);
+    }
+
+    // Undo the last n flips of the current chain
+    void pop_flips(size_t n) noexcept {
+        for (size_t i = 0; i < n; ++i) {
+            const auto [from, to] = this->flips.back();
+            this->tour.flip(to, from);
+            this->flips.pop_back();
+        }
+    }
+
+    // Record the closed gain of the current chain, if it's the best one so far
+    void update_best(cost_t closed_gain) noexcept {
+        if (closed_gain > this->best_gain) {
+            this->best_gain = closed_gain;
+            this->best_depth = this->flips.size();
+        }
+    }
+
+    // Try the or3opt moves that add (t2, t3) and remove (t3, t4), where t4 = next(t3), and extend
+    // the chain after each of them. g_1 is the partial gain of the chain after adding (t2, t3).
+    // Return true iff a chain with positive closed gain has been found, in which case the flips
+    // are left applied.
+    bool or3opt_step(const PermutationPath<T, Index>& path, cost_t g_1, size_t t1, size_t t2,
+                     size_t t3) noexcept {
+        const size_t t4 = this->tour.next(t3);
+        const cost_t g_2 = g_1 + path.distance_between(t3, t4);
+        size_t n_tried = 0;
+
+        const size_t* first = this->neighbor_lists.begin(t4);
+        const size_t* last = this->neighbor_lists.end(t4);
+
+        for (auto it = first; it != last && n_tried < BREADTH[1]; ++it) {
+            const size_t t5 = *it;
+            const cost_t g_3 = g_2 - path.distance_between(t4, t5);
+
+            if (g_3 <= 0) {
+                break;
+            }
+
+            // (t5, t6) must be an edge of the segment t2..t3
+            if (t5 == t3 || !this->tour.between(t2, t5, t3)) {
+                continue;
+            }
+
+            ++n_tried;
+
+            const size_t t6 = this->tour.next(t5);
+            const cost_t g_4 = g_3 + path.distance_between(t5, t6);
+            const cost_t closed_gain = g_4 - path.distance_between(t6, t1);
+
+            // t1->t2->...->t5->t6->...->t3->t4 becomes t1->t6->...->t3->t2->...->t5->t4, by
+            // reversing t2..t3 first, and then each of the two segments back
+            this->push_flip(t2, t3);
+            this->push_flip(t3, t6);
+            this->push_flip(t5, t2);
+            this->added_edges.emplace_back(t2, t3);
+            this->added_edges.emplace_back(t4, t5);
+            this->touched.insert(this->touched.end(), {t3, t4, t5, t6});
+
+            this->update_best(closed_gain);
+
+            // the or3opt move takes the first 2 levels of the chain
+            if constexpr (MAX_DEPTH > 2) {
+                this->step(path, 3, g_4, t1, t6);
+            }
+
+            if (this->best_gain > 0) {
+                return true;
+            }
+
+            // undo the move and try the next alternative
+            this->pop_flips(3);
+            this->added_edges.resize(this->added_edges.size() - 2);
+            this->touched.resize(this->touched.size() - 4);
+        }
+
+        return false;
+    }
+
+    // Extend the chain at the given depth, where t2 = next(t1) and g is the partial gain of the
+    // chain without its closing edge. Return true iff a chain with positive closed gain has been
+    // found, in which case the flips are left applied.
+    bool step(const PermutationPath<T, Index>& path, size_t depth, cost_t g, size_t t1,
+              size_t t2) noexcept {
+        const size_t breadth = depth <= std::size(BREADTH) ? BREADTH[depth - 1] : 1;
+        size_t n_tried = 0;
+
+        const size_t* first = this->neighbor_lists.begin(t2);
+        const size_t* last = this->neighbor_lists.end(t2);
+
+        for (auto it = first; it != last && n_tried < breadth; ++it) {
+            const size_t t3 = *it;
+            const cost_t g_1 = g - path.distance_between(t2, t3);
+
+            // the candidate lists are sorted, so no farther neighbor can keep the gain positive
+            if (g_1 <= 0) {
+                break;
+            }
+
+            if (t3 == t1 || t3 == this->tour.next(t2)) {
+                continue;
+            }
+
+            // at the first level, the or3opt moves are tried before the flip
+            if (depth == 1 && this->or3opt_step(path, g_1, t1, t2, t3)) {
+                return true;
+            }
+
+            // t1->t2->...->t4->t3 becomes t1->t4->...->t2->t3
+            const size_t t4 = this->tour.prev(t3);
+            if (this->is_added_edge(t4, t3)) {
+                continue;
+            }
+
+            ++n_tried;
+
+            const cost_t g_2 = g_1 + path.distance_between(t4, t3);
+            const cost_t closed_gain = g_2 - path.distance_between(t4, t1);
+
+            this->push_flip(t2, t4);
+            this->added_edges.emplace_back(t2, t3);
+            this->touched.push_back(t3);
+            this->touched.push_back(t4);
+
+            this->update_best(closed_gain);
+
+            if (depth < MAX_DEPTH) {
+                this->step(path, depth + 1, g_2, t1, t4);
+            }
+
+            if (this->best_gain > 0) {
+                return true;
+            }
+
+            // undo the flip and try the next alternative
+            this->pop_flips(1);
+            this->added_edges.pop_back();
+            this->touched.pop_back();
+            this->touched.pop_back();
+        }
+
+        return false;
+    }
+
+    // Look for an improving chain that starts by removing one of the edges adjacent to city t1,
+    // and apply the best prefix of the first one found. Return true iff the path has been
+    // improved.
+    bool improve_city(PermutationPath<T, Index>& path, size_t t1) noexcept {
+        for (size_t side = 0; side < 2; ++side) {
+            // on the second iteration, (prev(t1), t1) is the first removed edge
+            if (side == 1) {
+                this->tour.reverse();
+            }
+
+            const size_t t2 = this->tour.next(t1);
+
+            this->flips.clear();
+            this->added_edges.clear();
+            this->touched.clear();
+            this->best_gain = 0;
+            this->best_depth = 0;
+
+            if (this->step(path, 1, path.distance_between(t1, t2), t1, t2)) {
+                // undo the flips that follow the best closed chain
+                this->pop_flips(this->flips.size() - this->best_depth);
+
+                path.update_cost(-this->best_gain);
+
+                this->queue.push(t1);
+                this->queue.push(t2);
+                this->queue.push(this->touched.cbegin(), this->touched.cend());
+                return true;
+            }
+        }
+
+        return false;
+    }
+
+public:
+    explicit LinKernighanSearch(const NeighborLists& neighbor_lists) :
+        neighbor_lists(neighbor_lists),
+        tour(neighbor_lists.size()),
+        queue(neighbor_lists.size()) {
+        this->flips.reserve(MAX_FLIPS);
+        this->added_edges.reserve(MAX_DEPTH);
+        this->touched.reserve(2 * MAX_DEPTH);
+    }
+
+    // Apply improving chains to the given path until none can be found w.r.t. the candidate
+    // lists. The path keeps starting from city 0.
+    // Return true iff at least one chain has been applied.
+    bool improve(PermutationPath<T, Index>& path) noexcept {
+        this->tour.attach(path);
+        this->queue.push(path.begin(), path.end());
+
+        bool improved = false;
+        while (!this->queue.empty()) {
+            const size_t t1 = this->queue.pop();
+            improved |= this->improve_city(path, t1);
+        }
+
+        utils::shift_to_value<size_t>(path.begin(), path.end(), 0);
+        return improved;
+    }
+};
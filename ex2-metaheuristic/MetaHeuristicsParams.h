@@ -1,5 +1,9 @@
 #pragma once
 
+namespace solver {
+    enum class LocalSearchType { VARIABLE_NEIGHBORHOOD, TWO_OPT, TWO_OPT_OR_OPT, LIN_KERNIGHAN };
+}  // namespace solver
+
 struct MetaHeuristicsParams {
     // Probability that a new offspring is mutated.
     // Acceptable range: [0, 1]
@@ -26,4 +30,7 @@ struct MetaHeuristicsParams {
     // Size of the tournament.
     // Acceptable range: [2, mu]
     size_t tournament_k;
+
+    // Local search strategy used to improve the initial generation and the following ones.
+    solver::LocalSearchType local_search_type;
 };
\ No newline at end of file
@@ -0,0 +1,169 @@
+#pragma once
+
+#include <shared/NeighborLists.h>
+#include <shared/path_utils/PermutationPath.h>
+
+#include "DontLookQueue.h"
+#include "TourIndex.h"
+#include "utils.h"
+
+/**
+ * Or-opt local search driven by candidate lists and don't-look bits.
+ * An Or-opt move relocates a segment of 1 to 3 consecutive cities, optionally reversed, between
+ * two other adjacent cities. The segment endpoints are only moved next to one of their nearest
+ * neighbors, and only when the new edge is shorter than the gain obtained by removing the
+ * segment, so every move is evaluated in O(1).
+ * Its buffers are allocated once and reused for every path it improves.
+ */
+template <typename T, typename Index>
+class OrOptSearch {
+    using cost_t = typename PermutationPath<T, Index>::cost_t;
+
+    // Maximum number of cities in a relocated segment
+    static constexpr size_t MAX_SEGMENT_LENGTH = 3;
+
+    // Constant reference to the candidate lists of each city
+    const NeighborLists& neighbor_lists;
+
+    // Position index of the path being improved
+    TourIndex<T, Index> tour;
+
+    // Cities whose don't-look bit is off
+    DontLookQueue queue;
+
+    // Move the segment that goes forward from s_1 to s_2 between u and v = next(u).
+    // If reversed is true, the result is u->s_2->...->s_1->v, otherwise u->s_1->...->s_2->v.
+    void move_segment(size_t s_1, size_t s_2, size_t u, bool reversed) noexcept {
+        const size_t q = this->tour.next(s_2);
+
+        // p->s_1->...->s_2->q->...->u->v becomes p->u->...->q->s_2->...->s_1->v
+        this->tour.flip(s_1, u);
+
+        // p->u->...->q->s_2->...->s_1->v becomes p->q->...->u->s_2->...->s_1->v
+        this->tour.flip(u, q);
+
+        if (!reversed) {
+            this->tour.flip(s_2, s_1);
+        }
+    }
+
+    // Look for an improving Or-opt move of a segment that has city a as one of its endpoints,
+    // and apply the first one found. Return true iff the path has been improved.
+    bool improve_city(PermutationPath<T, Index>& path, size_t a) noexcept {
+        const size_t n = path.size();
+
+        for (size_t length = 1; length <= MAX_SEGMENT_LENGTH && length + 3 <= n; ++length) {
+            for (const bool a_first : {true, false}) {
+                if (length == 1 && !a_first) {
+                    continue;
+                }
+
+                // the segment goes forward from s_1 to s_2
+                size_t s_1 = a;
+                size_t s_2 = a;
+                for (size_t i = 1; i < length; ++i) {
+                    if (a_first) {
+                        s_2 = this->tour.next(s_2);
+                    } else {
+                        s_1 = this->tour.prev(s_1);
+                    }
+                }
+
+                const size_t p = this->tour.prev(s_1);
+                const size_t q = this->tour.next(s_2);
+
+                const cost_t removal_gain = path.distance_between(p, s_1) +
+                                            path.distance_between(s_2, q) -
+                                            path.distance_between(p, q);
+
+                if (removal_gain <= 0) {
+                    continue;
+                }
+
+                const auto in_segment = [&](size_t city) -> bool {
+                    return this->tour.between(s_1, city, s_2);
+                };
+
+                for (const size_t e : {s_1, s_2}) {
+                    const size_t* first = this->neighbor_lists.begin(e);
+                    const size_t* last = this->neighbor_lists.end(e);
+
+                    for (auto it = first; it != last; ++it) {
+                        const size_t c = *it;
+                        const cost_t d_ec = path.distance_between(e, c);
+
+                        // the candidate lists are sorted, so no farther neighbor can yield a gain
+                        if (d_ec >= removal_gain) {
+                            break;
+                        }
+
+                        if (in_segment(c)) {
+                            continue;
+                        }
+
+                        // insert the segment either in the edge (c, next(c)) or (prev(c), c),
+                        // oriented so that e is adjacent to c
+                        for (const bool after_c : {true, false}) {
+                            const size_t u = after_c ? c : this->tour.prev(c);
+                            const size_t v = after_c ? this->tour.next(c) : c;
+
+                            if (in_segment(u) || in_segment(v)) {
+                                continue;
+                            }
+
+                            const bool reversed = after_c ? e == s_2 : e == s_1;
+
+                            const cost_t insertion_cost =
+                                reversed ? path.distance_between(u, s_2) +
+                                               path.distance_between(s_1, v)
+                                         : path.distance_between(u, s_1) +
+                                               path.distance_between(s_2, v);
+
+                            const cost_t delta =
+                                insertion_cost - path.distance_between(u, v) - removal_gain;
+
+                            if (delta < 0) {
+                                this->move_segment(s_1, s_2, u, reversed);
+                                path.update_cost(delta);
+
+                                this->queue.push(p);
+                                this->queue.push(q);
+                                this->queue.push(u);
+                                this->queue.push(v);
+                                this->queue.push(s_1);
+                                this->queue.push(s_2);
+                                return true;
+                            }
+                        }
+                    }
+                }
+            }
+        }
+
+        return false;
+    }
+
+public:
+    explicit OrOptSearch(const NeighborLists& neighbor_lists) :
+        neighbor_lists(neighbor_lists),
+        tour(neighbor_lists.size()),
+        queue(neighbor_lists.size()) {
+    }
+
+    // Apply improving Or-opt moves to the given path until it's a local optimum w.r.t. the
+    // candidate lists. The path keeps starting from city 0.
+    // Return true iff at least one move has been applied.
+    bool improve(PermutationPath<T, Index>& path) noexcept {
+        this->tour.attach(path);
+        this->queue.push(path.begin(), path.end());
+
+        bool improved = false;
+        while (!this->queue.empty()) {
+            const size_t a = this->queue.pop();
+            improved |= this->improve_city(path, a);
+        }
+
+        utils::shift_to_value<size_t>(path.begin(), path.end(), 0);
+        return improved;
+    }
+};
@@ -0,0 +1,129 @@
+#pragma once
+
+#include <shared/Distances.h>
+#include <shared/path_utils/PermutationPath.h>
+
+#include <memory>  // std::align
+#include <vector>  // std::vector
+
+/**
+ * PathStore stores up to capacity paths of n cities each in a single contiguous slab, one path per
+ * row, together with the parallel array of their costs. Every row starts at a cache line boundary,
+ * so the rows can be walked linearly, e.g. by vectorized code.
+ * The paths are accessed through PermutationPath views over the rows: the operators that work on
+ * a PermutationPath work on the paths of the store as well, and copying a path into a row never
+ * allocates memory.
+ * The rows are reference counted, so that several PopulationPool can share them: a row is free
+ * again as soon as no pool refers to it.
+ */
+template <typename T, typename Index>
+class PathStore {
+public:
+    using path_t = PermutationPath<T, Index>;
+    using cost_t = typename path_t::cost_t;
+
+private:
+    // alignment of each row, in bytes
+    static constexpr size_t CACHE_LINE = 64;
+
+    // number of cities of each path
+    size_t n;
+
+    // view over the distances between the cities of the paths
+    Distances<T> distances;
+
+    // cities of the slab, with some room for aligning its first row to a cache line
+    std::vector<Index> storage;
+
+    // costs[r] is the memoized cost of the path in the r-th row
+    std::vector<cost_t> costs;
+
+    // views over the rows of the slab
+    std::vector<path_t> paths;
+
+    // references[r] is the number of references to the r-th row
+    std::vector<size_t> references;
+
+    // stack of the rows that aren't referenced
+    std::vector<size_t> free_rows;
+
+public:
+    // Create a store with room for capacity paths of n cities, whose distances are provided by
+    // distances
+    PathStore(size_t capacity, size_t n, Distances<T> distances) :
+        n(n), distances(distances), costs(capacity), references(capacity, 0) {
+        // the distance between the first cities of two consecutive rows is a multiple of the
+        // number of cities in a cache line
+        const size_t cities_per_line = CACHE_LINE / sizeof(Index);
+        const size_t stride = (n + cities_per_line - 1) / cities_per_line * cities_per_line;
+
+        storage.resize(capacity * stride + cities_per_line);
+        void* slab = storage.data();
+        size_t space = storage.size() * sizeof(Index);
+        std::align(CACHE_LINE, capacity * stride * sizeof(Index), slab, space);
+
+        paths.reserve(capacity);
+        for (size_t r = 0; r < capacity; ++r) {
+            paths.emplace_back(static_cast<Index*>(slab) + r * stride, n, &costs[r], distances);
+        }
+
+        // the first rows are acquired first
+        free_rows.reserve(capacity);
+        for (size_t r = capacity; r > 0; --r) {
+            free_rows.push_back(r - 1);
+        }
+    }
+
+    // the views point to the storage of this store
+    PathStore(const PathStore&) = delete;
+    PathStore& operator=(const PathStore&) = delete;
+
+    // Return the maximum number of paths in the store
+    [[nodiscard]] size_t capacity() const noexcept {
+        return paths.size();
+    }
+
+    // Return the number of cities of each path
+    [[nodiscard]] size_t path_size() const noexcept {
+        return n;
+    }
+
+    // Return the view over the distances between the cities of the paths
+    [[nodiscard]] const Distances<T>& get_distances() const noexcept {
+        return distances;
+    }
+
+    // Return a free row, referenced once. Its cities are unspecified until they're assigned.
+    // Precondition: not every row is referenced.
+    [[nodiscard]] size_t acquire() noexcept {
+        const size_t row = free_rows.back();
+        free_rows.pop_back();
+        references[row] = 1;
+        return row;
+    }
+
+    // Add a reference to the given row
+    void retain(size_t row) noexcept {
+        ++references[row];
+    }
+
+    // Remove a reference to the given row, which is free again once it isn't referenced anymore
+    void release(size_t row) noexcept {
+        if (--references[row] == 0) {
+            free_rows.push_back(row);
+        }
+    }
+
+    // Return true if the given row is referenced more than once
+    [[nodiscard]] bool is_shared(size_t row) const noexcept {
+        return references[row] > 1;
+    }
+
+    [[nodiscard]] path_t& path(size_t row) noexcept {
+        return paths[row];
+    }
+
+    [[nodiscard]] const path_t& path(size_t row) const noexcept {
+        return paths[row];
+    }
+};
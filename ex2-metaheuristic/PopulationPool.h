@@ -0,0 +1,152 @@
+#pragma once
+
+#include <shared/Distances.h>
+#include <shared/path_utils/PermutationPath.h>
+
+#include <memory>   // std::shared_ptr
+#include <utility>  // std::move, std::swap
+#include <vector>   // std::vector
+
+#include "PathStore.h"
+
+/**
+ * PopulationPool is a pool of paths whose cities are stored in the rows of a PathStore.
+ * The pool refers to its paths by row, so selecting a path of a pool into another pool shares the
+ * row rather than copying the path. The paths are read-only: a path is copied into a row of its
+ * own only when a pool modifies it while other pools still refer to it (copy-on-write).
+ */
+template <typename T, typename Index>
+class PopulationPool {
+public:
+    using path_t = PermutationPath<T, Index>;
+    using cost_t = typename path_t::cost_t;
+    using store_t = PathStore<T, Index>;
+
+private:
+    // store of the cities and of the costs of the paths
+    std::shared_ptr<store_t> store;
+
+    // rows[i] is the row of the i-th path of the pool
+    std::vector<size_t> rows;
+
+public:
+    // Create an empty pool with room for capacity paths stored in store
+    PopulationPool(std::shared_ptr<store_t> store, size_t capacity) : store(std::move(store)) {
+        rows.reserve(capacity);
+    }
+
+    // copying a pool would need to reference its rows once more
+    PopulationPool(const PopulationPool&) = delete;
+    PopulationPool& operator=(const PopulationPool&) = delete;
+
+    PopulationPool(PopulationPool&& other) noexcept :
+        store(std::move(other.store)), rows(std::move(other.rows)) {
+        other.rows.clear();
+    }
+
+    PopulationPool& operator=(PopulationPool&& other) noexcept {
+        if (this != &other) {
+            this->clear();
+            this->store = std::move(other.store);
+            this->rows = std::move(other.rows);
+            other.rows.clear();
+        }
+
+        return *this;
+    }
+
+    ~PopulationPool() {
+        this->clear();
+    }
+
+    // Swap the paths of a and b, which must share the same store, without copying them
+    friend void swap(PopulationPool& a, PopulationPool& b) noexcept {
+        using std::swap;
+        swap(a.store, b.store);
+        swap(a.rows, b.rows);
+    }
+
+    // Return the number of paths in the pool
+    [[nodiscard]] size_t size() const noexcept {
+        return rows.size();
+    }
+
+    [[nodiscard]] bool empty() const noexcept {
+        return rows.empty();
+    }
+
+    // Return the number of cities of each path
+    [[nodiscard]] size_t path_size() const noexcept {
+        return store->path_size();
+    }
+
+    // Return the view over the distances between the cities of the paths
+    [[nodiscard]] const Distances<T>& get_distances() const noexcept {
+        return store->get_distances();
+    }
+
+    // Return the store of the rows of the pool
+    [[nodiscard]] const std::shared_ptr<store_t>& get_store() const noexcept {
+        return store;
+    }
+
+    // Copy the given path, which must have path_size() cities, into a new row at the end of the
+    // pool
+    void push_back(const path_t& path) noexcept {
+        const size_t row = store->acquire();
+        store->path(row) = path;
+        rows.push_back(row);
+    }
+
+    // Add a path at the end of the pool, in a new row, and return it for writing its cities,
+    // which are unspecified until they're assigned
+    [[nodiscard]] path_t& emplace_back() noexcept {
+        rows.push_back(store->acquire());
+        return store->path(rows.back());
+    }
+
+    // Share the j-th path of other at the end of the pool, without copying it
+    void push_back(const PopulationPool& other, size_t j) noexcept {
+        store->retain(other.rows[j]);
+        rows.push_back(other.rows[j]);
+    }
+
+    // Share the j-th path of other as the i-th path of the pool, without copying it
+    void replace(size_t i, const PopulationPool& other, size_t j) noexcept {
+        store->retain(other.rows[j]);
+        store->release(rows[i]);
+        rows[i] = other.rows[j];
+    }
+
+    // Remove every path from the pool
+    void clear() noexcept {
+        for (size_t row : rows) {
+            store->release(row);
+        }
+
+        rows.clear();
+    }
+
+    // Return the cost of the i-th path, computing it if it hasn't been memoized yet
+    [[nodiscard]] cost_t cost(size_t i) const noexcept {
+        return store->path(rows[i]).cost();
+    }
+
+    const path_t& operator[](size_t i) const noexcept {
+        return store->path(rows[i]);
+    }
+
+    // Return the i-th path for modifying it. If its row is shared with other paths, the path is
+    // copied into a row of its own first.
+    [[nodiscard]] path_t& modify(size_t i) noexcept {
+        const size_t row = rows[i];
+
+        if (store->is_shared(row)) {
+            rows[i] = store->acquire();
+            store->path(rows[i]) = store->path(row);
+            store->release(row);
+        }
+
+        return store->path(rows[i]);
+    }
+};
@@ -1,14 +1,28 @@
 ﻿#pragma once
 
 #include <optional>  // std::optional
+#include <utility>   // std::move, std::swap
 #include <vector>    // std::vector
 
-// Abstract genetic algorithm solver
-template <typename T>
+// Abstract genetic algorithm solver. T is the type of the solutions, and Pool is the type of the
+// pools of solutions, e.g. std::vector<T>.
+// The pools are owned by the solver and filled in place at each generation, so that they keep
+// their capacity across generations.
+template <typename T, class Pool = std::vector<T>>
 class Solver {
 protected:
     // Store the population pool
-    std::vector<T> population_pool;
+    Pool population_pool;
+
+    // Store the population pool of the next generation, which is swapped with population_pool at
+    // the end of each iteration
+    Pool next_population_pool;
+
+    // Store the mating pool of the current iteration
+    Pool mating_pool;
+
+    // Store the offspring pool of the current iteration
+    Pool offspring_pool;
 
     // Keep track of the best solution so far
     std::optional<T> best_solution;
@@ -25,50 +39,76 @@ protected:
     // Return true when the first solution is better than the second.
     [[nodiscard]] virtual bool solution_comparator(const T& a, const T& b) const noexcept = 0;
 
-    // Compute the initial population pool
-    [[nodiscard]] virtual std::vector<T> compute_initial_population_pool() noexcept = 0;
+    // Compute the initial population pool into the given empty pool
+    virtual void compute_initial_population_pool(Pool& population_pool) noexcept = 0;
 
-    // Compute the mating pool of size λ of the current iteration
-    [[nodiscard]] virtual std::vector<T> compute_current_mating_pool() noexcept = 0;
+    // Compute the mating pool of size λ of the current iteration into the given empty pool
+    virtual void compute_current_mating_pool(Pool& mating_pool) noexcept = 0;
 
-    // Compute the new generation of λ offsprings from a mating pool of size λ.
-    [[nodiscard]] virtual std::vector<T> compute_current_offspring_pool(
-        std::vector<T>& mating_pool) noexcept = 0;
+    // Compute the new generation of λ offsprings from a mating pool of size λ into the given
+    // empty pool
+    virtual void compute_current_offspring_pool(const Pool& mating_pool,
+                                                Pool& offspring_pool) noexcept = 0;
 
     // Perform a mutation of some of the given offsprings
-    virtual void mutate_offsprings(std::vector<T>& offspring_pool) noexcept = 0;
+    virtual void mutate_offsprings(Pool& offspring_pool) noexcept = 0;
 
-    // Select new generation's population pool
-    virtual void select_new_generation(std::vector<T>&& mating_pool,
-                                       std::vector<T>&& offspring_pool) noexcept = 0;
+    // Select new generation's population pool into the given empty pool
+    virtual void select_new_generation(const Pool& mating_pool, const Pool& offspring_pool,
+                                       Pool& next_population_pool) noexcept = 0;
 
     // If true, create a new generation iteration
     [[nodiscard]] virtual bool should_continue() noexcept = 0;
 
     // Run a single iteration
     virtual void perform_iteration() noexcept {
+        this->compute_current_mating_pool(this->mating_pool);
+        this->compute_current_offspring_pool(this->mating_pool, this->offspring_pool);
+        this->mutate_offsprings(this->offspring_pool);
+        this->select_new_generation(this->mating_pool, this->offspring_pool,
+                                    this->next_population_pool);
+
+        // the new generation becomes the population, the pools of the old one are emptied but
+        // keep their capacity
+        using std::swap;
+        swap(this->population_pool, this->next_population_pool);
+        this->next_population_pool.clear();
+        this->mating_pool.clear();
+        this->offspring_pool.clear();
+
         // Increment the number of generations
         this->n_generations++;
     }
 
-    // Compute the best solution of the given pool and returns a copy of it.
+    // Compute the index of the best solution of the given pool.
     // The pool must contain at least one element.
-    [[nodiscard]] T compute_best_solution(std::vector<T>& pool) const noexcept {
-        auto comparator = [this](const auto& a, const auto& b) -> bool {
-            return this->solution_comparator(a, b);
-        };
+    [[nodiscard]] size_t compute_best_solution_index(const Pool& pool) const noexcept {
+        size_t best_index = 0;
+
+        for (size_t i = 1; i < pool.size(); ++i) {
+            if (this->solution_comparator(pool[i], pool[best_index])) {
+                best_index = i;
+            }
+        }
 
-        auto best_it = std::min_element(pool.cbegin(), pool.cend(), comparator);
+        return best_index;
+    }
 
-        return T(*best_it);
+    // Compute the best solution of the given pool and returns a copy of it.
+    // The pool must contain at least one element.
+    [[nodiscard]] T compute_best_solution(const Pool& pool) const noexcept {
+        return T(pool[this->compute_best_solution_index(pool)]);
     }
 
+    // Update the best solution with the best solution of the population pool, if it's better.
+    // The best solution is overwritten in place, so it's copied only when it improves.
     void update_best_solution() noexcept {
-        const T current_best_solution = this->compute_best_solution(this->population_pool);
+        const T& current_best_solution =
+            this->population_pool[this->compute_best_solution_index(this->population_pool)];
 
         if (this->solution_comparator(current_best_solution, this->best_solution.value())) {
 
-            this->best_solution = {std::move(current_best_solution)};
+            this->best_solution.value() = current_best_solution;
             this->n_generations_without_improvement = 0;
         } else {
             this->n_generations_without_improvement++;
@@ -79,6 +119,16 @@ public:
     explicit Solver() noexcept {
     }
 
+    // Pools that aren't default-constructible, e.g. the ones with a fixed capacity, are passed
+    // to the solver already built
+    explicit Solver(Pool&& population_pool, Pool&& next_population_pool, Pool&& mating_pool,
+                    Pool&& offspring_pool) noexcept :
+        population_pool(std::move(population_pool)),
+        next_population_pool(std::move(next_population_pool)),
+        mating_pool(std::move(mating_pool)),
+        offspring_pool(std::move(offspring_pool)) {
+    }
+
     virtual ~Solver() noexcept {
     }
 
@@ -1,16 +1,26 @@
 ﻿#pragma once
 
-#include <shared/DistanceMatrix.h>
+#include <shared/Distances.h>
+#include <shared/NeighborLists.h>
 #include <shared/path_utils/PermutationPath.h>
 
-#include <algorithm>      // std::find_if
-#include <random>         // std::mt19937, std::random_device
+#include <algorithm>      // std::min
+#include <cstdint>        // uint32_t
+#include <memory>         // std::make_shared
+#include <random>         // std::mt19937, std::random_device, std::uniform_int_distribution
 #include <unordered_set>  // std::unordered_set
 #include <vector>         // std::vector
 
+#include "LinKernighanSearch.h"
 #include "MetaHeuristicsParams.h"
 #include "Solver.h"
+#include "OrOptSearch.h"
+#include "PathStore.h"
+#include "PopulationPool.h"
 #include "SolverTablePrinter.h"
+#include "TwoOptSearch.h"
+#include "allocation_counter.h"
+#include "crossover.h"
 #include "decay.h"
 #include "farthest_insertion.h"
 #include "local_search.h"
@@ -23,40 +33,67 @@
 
 namespace solver {
     enum class SelectionType { TOURNAMENT, EXPONENTIAL_RANKING };
-    enum class MutationType { SWAP, LEFT_ROTATION, RIGHT_ROTATION, INVERSION };
+    enum class MutationType { SWAP, LEFT_ROTATION, RIGHT_ROTATION, INVERSION, OR_OPT };
 }  // namespace solver
 
-template <typename T, bool elitism = true,
+// The type T indicates the type of the distances, while Index is the type of the cities stored in
+// each path of the population (see PermutationPath).
+template <typename T, typename Index = uint32_t, bool elitism = true,
           solver::SelectionType selection_type = solver::SelectionType::TOURNAMENT,
           solver::MutationType mutation_type = solver::MutationType::LEFT_ROTATION>
-class TSPSolver : public Solver<PermutationPath<T>> {
-    using super = Solver<PermutationPath<T>>;
+class TSPSolver : public Solver<PermutationPath<T, Index>, PopulationPool<T, Index>> {
+    using super = Solver<PermutationPath<T, Index>, PopulationPool<T, Index>>;
+    using path_t = PermutationPath<T, Index>;
+    using pool_t = PopulationPool<T, Index>;
+    using store_t = PathStore<T, Index>;
 
-    // Constant reference to the distance matrix of the TSP problem
-    const DistanceMatrix<T>& distance_matrix;
+    // View over the distance matrix or the distance oracle of the TSP problem
+    Distances<T> distances;
 
     // Parameters that regulate the meta-heuristic algorithm search strategy
     MetaHeuristicsParams params;
 
+    // Candidate-list driven 2-opt local search, used when params.local_search_type is TWO_OPT
+    // or TWO_OPT_OR_OPT
+    TwoOptSearch<T, Index> two_opt;
+
+    // Candidate-list driven Or-opt local search, used when params.local_search_type is
+    // TWO_OPT_OR_OPT
+    OrOptSearch<T, Index> or_opt;
+
+    // Lin-Kernighan style local search, used when params.local_search_type is LIN_KERNIGHAN
+    LinKernighanSearch<T, Index> lin_kernighan;
+
     // Random generator instance
     std::mt19937 random_generator;
 
     // Size of the path
-    const size_t n = this->distance_matrix.size();
+    const size_t n = this->distances.size();
 
     // Heuristic solution
-    PermutationPath<T> heuristic_solution =
-        TSPSolver::compute_initial_heuristic_solution<T>(this->distance_matrix);
+    path_t heuristic_solution = TSPSolver::compute_initial_heuristic_solution(this->distances);
 
     // When stop is set to true, the solver should stop
     volatile bool stop_cond = false;
 
+    // Exponential ranking distribution of the μ individuals of the population, used when
+    // selection_type is EXPONENTIAL_RANKING
+    const selection::parent::ExponentialRanking exponential_ranking;
+
+    // Buffers reused across generations, so that they're allocated only once
+    std::vector<size_t> by_rank;
+    std::vector<size_t> tournament_candidates;
+    selection::children::MuLambdaBuffers mu_lambda_buffers;
+    std::vector<size_t> indexes_to_mutate;
+
+    // Number of heap allocations performed by the generations after the first one, which sizes
+    // the buffers reused by the following ones
+    size_t n_steady_state_allocations = 0;
+
     // Compute the initial solution according to a heuristic.
-    template <typename V>
-    static PermutationPath<V> compute_initial_heuristic_solution(
-        const DistanceMatrix<T>& distance_matrix) noexcept {
-        std::vector<size_t> circuit(heuristic::farthest_insertion(distance_matrix));
-        PermutationPath<V> heuristic_path(std::move(circuit), distance_matrix);
+    static path_t compute_initial_heuristic_solution(const Distances<T>& distances) noexcept {
+        const std::vector<size_t> circuit(heuristic::farthest_insertion(distances));
+        path_t heuristic_path(circuit, distances);
 
         // initialize cost
         heuristic_path.cost();
@@ -64,35 +101,27 @@ class TSPSolver : public Solver<PermutationPath<T>> {
         return heuristic_path;
     }
 
-    void mutate_with_probability(std::vector<PermutationPath<T>>& pool) noexcept {
-        const double mutation_probability = this->params.mutation_probability;
-        const auto should_mutate = [=](double probability) -> bool {
-            return probability <= mutation_probability;
-        };
-
-        for (PermutationPath<T>& path : pool) {
-            // generate n - 1 random uniform probabilities in [0, 1)
-            auto probabilities(sampling::sample_probabilities(std::next(path.cbegin()), path.cend(),
-                                                              this->random_generator));
+    void mutate_with_probability(pool_t& pool) noexcept {
+        auto& indexes_to_mutate = this->indexes_to_mutate;
 
-            // select the indexes to mutate, i.e. the indexes where the probability is <= the
-            // given mutation probability
-            std::vector<size_t> indexes_to_mutate;
-
-            auto first = probabilities.cbegin();
-            auto last = probabilities.cend();
-            auto it = std::next(first);
-
-            while ((it = std::find_if(it, last, should_mutate)) != last) {
-                indexes_to_mutate.push_back(std::distance(first, it));
-                ++it;
-            }
+        for (size_t p = 0; p < pool.size(); ++p) {
+            // select the indexes to mutate in [1, n - 1), each one with the given mutation
+            // probability
+            sampling::sample_bernoulli_indexes(1, this->n - 1, this->params.mutation_probability,
+                                               indexes_to_mutate, this->random_generator);
 
             // if the selected indexes are odd, drop the last one
             if (indexes_to_mutate.size() % 2) {
                 indexes_to_mutate.pop_back();
             }
 
+            if (indexes_to_mutate.empty()) {
+                continue;
+            }
+
+            // the path is copied only if it's shared with other pools
+            path_t& path = pool.modify(p);
+
             // apply the mutation for every sequential pair of selected indexes
             for (size_t i = 0; i < indexes_to_mutate.size(); i += 2) {
                 size_t x = indexes_to_mutate[i];
@@ -108,80 +137,124 @@ class TSPSolver : public Solver<PermutationPath<T>> {
                     mutation::right_rotation(path, x, y);
                 } else if constexpr (mutation_type == MutationType::INVERSION) {
                     mutation::inversion(path, x, y);
+                } else if constexpr (mutation_type == MutationType::OR_OPT) {
+                    // relocate a segment of up to 3 cities, optionally reversed
+                    const size_t max_length = std::min<size_t>(3, y - x);
+                    const size_t length = std::uniform_int_distribution<size_t>(
+                        1, max_length)(this->random_generator);
+                    const bool reversed = std::bernoulli_distribution()(this->random_generator);
+
+                    mutation::or_opt(path, x, y, length, reversed);
                 }
             }
         }
     }
 
     // Try to improve the initial generation via local search
-    void improve_initial_generation(std::vector<PermutationPath<T>>& population_pool) noexcept {
-        local_search::improve_generation_simple(population_pool, this->random_generator);
+    void improve_initial_generation(pool_t& population_pool) noexcept {
+        using namespace solver;
+
+        switch (this->params.local_search_type) {
+        case LocalSearchType::VARIABLE_NEIGHBORHOOD:
+            local_search::improve_generation_simple(population_pool, this->random_generator);
+            break;
+        case LocalSearchType::TWO_OPT:
+            local_search::improve_generation_two_opt(population_pool, this->two_opt);
+            break;
+        case LocalSearchType::TWO_OPT_OR_OPT:
+            local_search::improve_generation_two_opt_or_opt(population_pool, this->two_opt,
+                                                            this->or_opt);
+            break;
+        case LocalSearchType::LIN_KERNIGHAN:
+            local_search::improve_generation_lin_kernighan(population_pool,
+                                                           this->lin_kernighan);
+            break;
+        }
     }
 
     // Try to improve the current generation via local search
-    void improve_generation(std::vector<PermutationPath<T>>& population_pool) noexcept {
-        local_search::improve_generation_greedy(population_pool, this->random_generator);
+    void improve_generation(pool_t& population_pool) noexcept {
+        using namespace solver;
+
+        switch (this->params.local_search_type) {
+        case LocalSearchType::VARIABLE_NEIGHBORHOOD:
+            local_search::improve_generation_greedy(population_pool, this->random_generator);
+            break;
+        case LocalSearchType::TWO_OPT:
+            local_search::improve_generation_two_opt(population_pool, this->two_opt);
+            break;
+        case LocalSearchType::TWO_OPT_OR_OPT:
+            local_search::improve_generation_two_opt_or_opt(population_pool, this->two_opt,
+                                                            this->or_opt);
+            break;
+        case LocalSearchType::LIN_KERNIGHAN:
+            local_search::improve_generation_lin_kernighan(population_pool,
+                                                           this->lin_kernighan);
+            break;
+        }
     }
 
 protected:
     // Return true when the first solution is better than the second.
-    [[nodiscard]] bool solution_comparator(const PermutationPath<T>& a,
-                                           const PermutationPath<T>& b) const noexcept override {
+    [[nodiscard]] bool solution_comparator(const path_t& a,
+                                           const path_t& b) const noexcept override {
         return a.cost() < b.cost();
     }
 
     // Compute the initial population pool of size μ
-    [[nodiscard]] std::vector<PermutationPath<T>> compute_initial_population_pool() noexcept
-        override {
-        return population::generate_initial(this->heuristic_solution, this->params.mu,
-                                            this->random_generator);
+    void compute_initial_population_pool(pool_t& population_pool) noexcept override {
+        population::generate_initial(this->heuristic_solution, population_pool, this->params.mu,
+                                     this->random_generator);
     }
 
     // Compute the mating pool of size λ of the current iteration.
-    [[nodiscard]] std::vector<PermutationPath<T>> compute_current_mating_pool() noexcept override {
+    void compute_current_mating_pool(pool_t& mating_pool) noexcept override {
         using namespace selection;
         using namespace solver;
 
         if constexpr (selection_type == SelectionType::EXPONENTIAL_RANKING) {
-            return parent::ranking(super::population_pool, this->params.lambda,
-                                   this->random_generator);
+            parent::ranking(super::population_pool, mating_pool, this->params.lambda,
+                            this->exponential_ranking, this->by_rank, this->random_generator);
         } else if constexpr (selection_type == SelectionType::TOURNAMENT) {
-            return parent::tournament(super::population_pool, this->params.lambda,
-                                      this->params.tournament_k, this->random_generator);
+            parent::tournament(super::population_pool, mating_pool, this->params.lambda,
+                               this->params.tournament_k, this->tournament_candidates,
+                               this->random_generator);
         }
     }
 
     // Compute the new generation of λ offsprings from a mating pool of size λ.
-    [[nodiscard]] std::vector<PermutationPath<T>> compute_current_offspring_pool(
-        std::vector<PermutationPath<T>>& mating_pool) noexcept override {
-        return mating::sequential_crossover(mating_pool, this->n, this->params.crossover_rate,
-                                            this->random_generator);
+    void compute_current_offspring_pool(const pool_t& mating_pool,
+                                        pool_t& offspring_pool) noexcept override {
+        mating::sequential_crossover(mating_pool, offspring_pool, this->n,
+                                     this->params.crossover_rate, this->random_generator);
     }
 
     // Perform a mutation of some of the given offsprings.
-    void mutate_offsprings(std::vector<PermutationPath<T>>& offspring_pool) noexcept override {
+    void mutate_offsprings(pool_t& offspring_pool) noexcept override {
         this->mutate_with_probability(offspring_pool);
     }
 
     // Select new generation's population pool.
     // It implements a (μ, λ) selection with elitism.
-    void select_new_generation(std::vector<PermutationPath<T>>&& mating_pool,
-                               std::vector<PermutationPath<T>>&& offspring_pool) noexcept override {
+    void select_new_generation(const pool_t& mating_pool, const pool_t& offspring_pool,
+                               pool_t& next_population_pool) noexcept override {
 
         using namespace selection;
 
-        PermutationPath<T> best_father(super::compute_best_solution(mating_pool));
+        const size_t best_father = super::compute_best_solution_index(mating_pool);
 
-        children::generational_mu_lambda_selection(
-            super::population_pool, std::move(offspring_pool), this->random_generator);
+        children::generational_mu_lambda_selection(offspring_pool, next_population_pool,
+                                                   this->params.mu,
+                                                   this->mu_lambda_buffers,
+                                                   this->random_generator);
 
         if constexpr (elitism) {
-            const T best_selected_offspring_cost =
-                super::compute_best_solution(super::population_pool).cost();
+            const auto best_selected_offspring_cost = next_population_pool.cost(
+                super::compute_best_solution_index(next_population_pool));
 
-            if (best_selected_offspring_cost > best_father.cost()) {
-                using std::swap;
-                swap(super::population_pool[1], best_father);
+            // the best father is shared with the mating pool rather than copied
+            if (best_selected_offspring_cost > mating_pool.cost(best_father)) {
+                next_population_pool.replace(1, mating_pool, best_father);
             }
         }
     }
@@ -198,26 +271,12 @@ protected:
                super::n_generations < this->params.max_n_generations;
     }
 
-    // Perform a single iteration of the genetic algorithm
-    void perform_iteration() noexcept override {
-        // Select λ members of a pool of μ individuals to create a mating pool.
-        std::vector<PermutationPath<T>> mating_pool(this->compute_current_mating_pool());
-
-        // Create the a new generation of λ offsprings from a mating pool of size λ.
-        std::vector<PermutationPath<T>> offspring_pool(
-            this->compute_current_offspring_pool(mating_pool));
-
-        // Perform a mutation of some offsprings
-        this->mutate_offsprings(offspring_pool);
-
-        // Select new generation's population pool
-        this->select_new_generation(std::move(mating_pool), std::move(offspring_pool));
-
-        super::perform_iteration();
-    }
-
     void init() noexcept {
-        super::population_pool = this->compute_initial_population_pool();
+        // the crossover set of cities of the solver thread is sized here rather than at the first
+        // recombination, which might happen after the first generation
+        crossover::detail::thread_city_stamps().clear(this->n);
+
+        this->compute_initial_population_pool(super::population_pool);
 
         // Compute the best solution
         super::best_solution = {super::compute_best_solution(super::population_pool)};
@@ -231,13 +290,33 @@ protected:
         std::cout << "Improved cost: " << super::best_solution.value().cost() << '\n';
     }
 
+    // The population, mating and offspring pools share the rows of store
+    TSPSolver(const std::shared_ptr<store_t>& store, Distances<T> distances,
+              const NeighborLists& neighbor_lists, const MetaHeuristicsParams& params) noexcept :
+        super(pool_t(store, params.mu), pool_t(store, params.mu), pool_t(store, params.lambda),
+              pool_t(store, params.lambda + params.lambda % 2)),
+        distances(distances),
+        params(params),
+        two_opt(neighbor_lists),
+        or_opt(neighbor_lists),
+        lin_kernighan(neighbor_lists),
+        random_generator(std::random_device()()),
+        exponential_ranking(params.mu) {
+        this->by_rank.reserve(params.mu);
+        this->tournament_candidates.reserve(params.tournament_k);
+        this->mu_lambda_buffers.probabilities.reserve(params.lambda);
+        this->mu_lambda_buffers.keys.reserve(params.lambda);
+        this->mu_lambda_buffers.selected_indexes.reserve(params.lambda);
+        this->indexes_to_mutate.reserve(this->n);
+    }
+
 public:
-    explicit TSPSolver(const DistanceMatrix<T>& distance_matrix,
+    explicit TSPSolver(Distances<T> distances, const NeighborLists& neighbor_lists,
                        const MetaHeuristicsParams& params) noexcept :
-        super(),
-        distance_matrix(distance_matrix),
-        params(params),
-        random_generator(std::random_device()()) {
+        // the store has room for the μ paths of the population and the λ new offsprings
+        TSPSolver(std::make_shared<store_t>(params.mu + params.lambda + params.lambda % 2,
+                                            distances.size(), distances),
+                  distances, neighbor_lists, params) {
     }
 
     ~TSPSolver() {
@@ -251,6 +330,11 @@ public:
         return this->stop_cond;
     }
 
+    // Return the number of heap allocations performed by the generations after the first one
+    [[nodiscard]] size_t get_steady_state_allocations() const noexcept {
+        return this->n_steady_state_allocations;
+    }
+
     // Run the solver
     void solve() noexcept override {
         // initialize first solutions
@@ -262,6 +346,7 @@ public:
         while (this->should_continue()) {
             const double avg_cost = statistics::average_cost(super::population_pool);
             const double previous_best_cost = super::best_solution.value().cost();
+            const size_t previous_n_allocations = allocation_counter::count();
 
             this->perform_iteration();
 
@@ -271,6 +356,11 @@ public:
 
             this->update_best_solution();
 
+            if (super::n_generations > 1) {
+                this->n_steady_state_allocations +=
+                    allocation_counter::count() - previous_n_allocations;
+            }
+
             const double current_best_cost = super::best_solution.value().cost();
 
             solver::table::row(std::cout, super::n_generations, previous_best_cost,
@@ -278,9 +368,10 @@ public:
                                super::n_generations_without_improvement);
         }
 
-        auto&& current_best_solution = super::compute_best_solution(super::population_pool);
+        const auto current_best_cost = super::population_pool.cost(
+            super::compute_best_solution_index(super::population_pool));
 
-        std::cout << '\n' << "Best of generations: " << current_best_solution.cost() << '\n';
+        std::cout << '\n' << "Best of generations: " << current_best_cost << '\n';
         this->improve_generation(super::population_pool);
 
         this->update_best_solution();
@@ -0,0 +1,127 @@
+#pragma once
+
+#include <shared/path_utils/PermutationPath.h>
+
+#include <vector>  // std::vector
+
+/**
+ * TourIndex augments a PermutationPath with the position of each city in it, so that the
+ * successor and predecessor of a city, betweenness queries and subpath reversals don't require
+ * scanning the path.
+ * Subpath reversals always reverse the shorter side of the circuit. When the complementary side is
+ * reversed, the orientation of the circuit is flipped instead, so that next() and prev() keep
+ * describing the intended circuit.
+ * The index is reused across paths of the same size to avoid allocations.
+ */
+template <typename T, typename Index>
+class TourIndex {
+    // Path currently indexed
+    PermutationPath<T, Index>* path = nullptr;
+
+    // position[city] is the index of city in path
+    std::vector<size_t> position;
+
+    // If true, the circuit must be read from right to left
+    bool reversed = false;
+
+    // Reverse the n_swaps * 2 elements of the circuit starting at index i and ending at index j,
+    // wrapping around the end of the path
+    void reverse_positions(size_t i, size_t j, size_t n_swaps) noexcept {
+        const size_t n = this->position.size();
+        PermutationPath<T, Index>& p = *this->path;
+
+        for (size_t s = 0; s < n_swaps; ++s) {
+            const size_t city_i = p[i];
+            const size_t city_j = p[j];
+            p[i] = city_j;
+            p[j] = city_i;
+            this->position[city_j] = i;
+            this->position[city_i] = j;
+
+            i = i == n - 1 ? 0 : i + 1;
+            j = j == 0 ? n - 1 : j - 1;
+        }
+    }
+
+public:
+    explicit TourIndex(size_t n) noexcept : position(n) {
+    }
+
+    // Index the given path. It takes O(n).
+    void attach(PermutationPath<T, Index>& path) noexcept {
+        this->path = &path;
+        this->reversed = false;
+
+        const size_t n = path.size();
+        for (size_t i = 0; i < n; ++i) {
+            this->position[path[i]] = i;
+        }
+    }
+
+    // Read the circuit the other way around. It takes O(1).
+    void reverse() noexcept {
+        this->reversed = !this->reversed;
+    }
+
+    // Return the city that follows the given city in the circuit
+    [[nodiscard]] size_t next(size_t city) const noexcept {
+        const size_t n = this->position.size();
+        const size_t i = this->position[city];
+
+        if (this->reversed) {
+            return (*this->path)[i == 0 ? n - 1 : i - 1];
+        }
+        return (*this->path)[i == n - 1 ? 0 : i + 1];
+    }
+
+    // Return the city that precedes the given city in the circuit
+    [[nodiscard]] size_t prev(size_t city) const noexcept {
+        const size_t n = this->position.size();
+        const size_t i = this->position[city];
+
+        if (this->reversed) {
+            return (*this->path)[i == n - 1 ? 0 : i + 1];
+        }
+        return (*this->path)[i == 0 ? n - 1 : i - 1];
+    }
+
+    // Return true iff b is met while walking the circuit forward from a to c, a and c included
+    [[nodiscard]] bool between(size_t a, size_t b, size_t c) const noexcept {
+        const size_t n = this->position.size();
+        const size_t pa = this->position[a];
+        const size_t pb = this->position[b];
+        const size_t pc = this->position[c];
+
+        if (this->reversed) {
+            return (pa + n - pb) % n <= (pa + n - pc) % n;
+        }
+        return (pb + n - pa) % n <= (pc + n - pa) % n;
+    }
+
+    // Reverse the subpath that goes forward from city a to city b, a and b included.
+    // E.g. flip(c, e) on the circuit a->b->c->d->e->f yields a->b->e->d->c->f.
+    // It takes O(min(m, n - m)), where m is the length of the subpath.
+    void flip(size_t a, size_t b) noexcept {
+        const size_t n = this->position.size();
+
+        // indexes of the subpath in the underlying path, from left to right
+        size_t i = this->position[this->reversed ? b : a];
+        size_t j = this->position[this->reversed ? a : b];
+        const size_t length = (j + n - i) % n + 1;
+
+        if (2 * length > n) {
+            // reverse the complementary subpath and read the circuit the other way around
+            this->reversed = !this->reversed;
+            const size_t complement_length = n - length;
+            if (complement_length < 2) {
+                return;
+            }
+
+            const size_t new_i = j == n - 1 ? 0 : j + 1;
+            const size_t new_j = i == 0 ? n - 1 : i - 1;
+            this->reverse_positions(new_i, new_j, complement_length / 2);
+        } else {
+            this->reverse_positions(i, j, length / 2);
+        }
+    }
+};
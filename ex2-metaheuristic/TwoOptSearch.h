@@ -0,0 +1,103 @@
+#pragma once
+
+#include <shared/NeighborLists.h>
+#include <shared/path_utils/PermutationPath.h>
+
+#include "DontLookQueue.h"
+#include "TourIndex.h"
+#include "utils.h"
+
+/**
+ * 2-opt local search driven by candidate lists and don't-look bits.
+ * For each city a, only the edges (a, c) where c is one of the nearest neighbors of a and
+ * δ(a, c) is shorter than the edge of a that would be removed are considered. A city whose
+ * neighborhood didn't yield any improving move is not looked at again until one of its adjacent
+ * edges changes, so each improvement pass takes near-linear time.
+ * Its buffers are allocated once and reused for every path it improves.
+ */
+template <typename T, typename Index>
+class TwoOptSearch {
+    using cost_t = typename PermutationPath<T, Index>::cost_t;
+
+    // Constant reference to the candidate lists of each city
+    const NeighborLists& neighbor_lists;
+
+    // Position index of the path being improved
+    TourIndex<T, Index> tour;
+
+    // Cities whose don't-look bit is off
+    DontLookQueue queue;
+
+    // Look for an improving 2-opt move that removes one of the edges adjacent to city a, and
+    // apply the first one found. Return true iff the path has been improved.
+    bool improve_city(PermutationPath<T, Index>& path, size_t a) noexcept {
+        for (const bool forward : {true, false}) {
+            const size_t a_next = forward ? this->tour.next(a) : this->tour.prev(a);
+            const cost_t d_a = path.distance_between(a, a_next);
+
+            const size_t* first = this->neighbor_lists.begin(a);
+            const size_t* last = this->neighbor_lists.end(a);
+
+            for (auto it = first; it != last; ++it) {
+                const size_t c = *it;
+                const cost_t d_ac = path.distance_between(a, c);
+
+                // the candidate lists are sorted, so no farther neighbor can yield a gain
+                if (d_ac >= d_a) {
+                    break;
+                }
+
+                const size_t c_next = forward ? this->tour.next(c) : this->tour.prev(c);
+                if (c == a_next || c_next == a) {
+                    continue;
+                }
+
+                // (a, a_next) and (c, c_next) are replaced by (a, c) and (a_next, c_next)
+                const cost_t delta = d_ac + path.distance_between(a_next, c_next) - d_a -
+                                     path.distance_between(c, c_next);
+
+                if (delta < 0) {
+                    if (forward) {
+                        this->tour.flip(a_next, c);
+                    } else {
+                        this->tour.flip(c, a_next);
+                    }
+
+                    path.update_cost(delta);
+
+                    this->queue.push(a);
+                    this->queue.push(a_next);
+                    this->queue.push(c);
+                    this->queue.push(c_next);
+                    return true;
+                }
+            }
+        }
+
+        return false;
+    }
+
+public:
+    explicit TwoOptSearch(const NeighborLists& neighbor_lists) :
+        neighbor_lists(neighbor_lists),
+        tour(neighbor_lists.size()),
+        queue(neighbor_lists.size()) {
+    }
+
+    // Apply improving 2-opt moves to the given path until it's a local optimum w.r.t. the
+    // candidate lists. The path keeps starting from city 0.
+    // Return true iff at least one move has been applied.
+    bool improve(PermutationPath<T, Index>& path) noexcept {
+        this->tour.attach(path);
+        this->queue.push(path.begin(), path.end());
+
+        bool improved = false;
+        while (!this->queue.empty()) {
+            const size_t a = this->queue.pop();
+            improved |= this->improve_city(path, a);
+        }
+
+        utils::shift_to_value<size_t>(path.begin(), path.end(), 0);
+        return improved;
+    }
+};
@@ -0,0 +1,25 @@
+#pragma once
+
+#include <cstddef>  // size_t
+
+/**
+ * Counter of the heap allocations performed by each thread. It's incremented by the replacement
+ * of the global operator new in count_allocations.h: in a program that doesn't include it, the
+ * counter stays at zero.
+ */
+namespace allocation_counter {
+    namespace detail {
+        // number of heap allocations performed by the current thread
+        inline thread_local size_t n_allocations = 0;
+    }  // namespace detail
+
+    // Return the number of heap allocations performed by the current thread so far
+    [[nodiscard]] inline size_t count() noexcept {
+        return detail::n_allocations;
+    }
+
+    // Record a heap allocation of the current thread
+    inline void increment() noexcept {
+        ++detail::n_allocations;
+    }
+}  // namespace allocation_counter
@@ -1,8 +1,12 @@
 #pragma once
 
 #include <argparse/include/argparse/argparse.hpp>
-#include <iostream>  // std::cout
-#include <string>    // std::string
+#include <shared/DistanceMatrix.h>
+#include <iostream>   // std::cout
+#include <stdexcept>  // std::runtime_error
+#include <string>     // std::string, std::string_literals
+
+#include "MetaHeuristicsParams.h"
 
 namespace cli {
     struct CLIArgs : public argparse::Args {
@@ -13,6 +17,13 @@ namespace cli {
 
         bool& show_path = flag("s,show-path", "Show the path of the solution").set_default(false);
 
+        bool& hilbert =
+            flag("hilbert", "Renumber the cities along a Hilbert curve").set_default(false);
+
+        std::string& distance_type =
+            kwarg("d,distance-type", "Type of the distances: double, int32, uint16")
+                .set_default("double");
+
         double& mutation_probability = kwarg("m,mutation-probability", "GA mutation probability")
                                            .set_default(0.018317703302043006);
 
@@ -33,6 +44,18 @@ namespace cli {
 
         unsigned int& k = kwarg("k", "Size of the GA tournament").set_default(13u);
 
+        std::string& local_search =
+            kwarg("l,local-search", "Local search strategy: vnd, 2-opt, 2-opt+or-opt, lk")
+                .set_default("vnd");
+
+        unsigned int& neighbors =
+            kwarg("neighbors", "Size of the candidate lists used by the local search")
+                .set_default(10u);
+
+        std::string& distance_layout =
+            kwarg("distance-layout", "Storage of the distances: full, packed, coordinates")
+                .set_default("full");
+
         // Show introductory message to the users
         void welcome() override {
             std::cout << "Metaheuristic solver\n";
@@ -42,4 +65,38 @@ namespace cli {
     CLIArgs parse(int argc, char** argv) {
         return argparse::parse<CLIArgs>(argc, argv);
     }
+
+    // Convert the name of a local search strategy to its solver::LocalSearchType value
+    solver::LocalSearchType parse_local_search_type(const std::string& name) {
+        if (name == "vnd") {
+            return solver::LocalSearchType::VARIABLE_NEIGHBORHOOD;
+        } else if (name == "2-opt") {
+            return solver::LocalSearchType::TWO_OPT;
+        } else if (name == "2-opt+or-opt") {
+            return solver::LocalSearchType::TWO_OPT_OR_OPT;
+        } else if (name == "lk") {
+            return solver::LocalSearchType::LIN_KERNIGHAN;
+        }
+
+        using namespace std::string_literals;
+        throw std::runtime_error("Unsupported local search strategy: "s + name);
+    }
+
+    // Return true if the distances should be computed on demand from the coordinates of the
+    // points, rather than stored in a distance matrix
+    bool is_coordinate_layout(const std::string& name) {
+        return name == "coordinates";
+    }
+
+    // Convert the name of a distance matrix storage layout to its DistanceMatrixLayout value
+    DistanceMatrixLayout parse_distance_layout(const std::string& name) {
+        if (name == "full") {
+            return DistanceMatrixLayout::FULL;
+        } else if (name == "packed") {
+            return DistanceMatrixLayout::PACKED;
+        }
+
+        using namespace std::string_literals;
+        throw std::runtime_error("Unsupported distance matrix layout: "s + name);
+    }
 }  // namespace cli
\ No newline at end of file
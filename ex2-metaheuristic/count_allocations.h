@@ -0,0 +1,53 @@
+#pragma once
+
+#include <cstdlib>  // std::malloc, std::free
+#include <new>      // std::bad_alloc
+
+#include "allocation_counter.h"
+
+/**
+ * Replacement of the global operator new that counts the heap allocations of each thread in
+ * allocation_counter. The replacements of the global allocation functions can't be inline, so
+ * this header must be included by a single translation unit of the program, i.e. main.cpp.
+ */
+
+void* operator new(std::size_t size) {
+    allocation_counter::increment();
+
+    if (void* p = std::malloc(size == 0 ? 1 : size)) {
+        return p;
+    }
+
+    throw std::bad_alloc();
+}
+
+void* operator new[](std::size_t size) {
+    return ::operator new(size);
+}
+
+// GCC sees that the pointers freed here come from operator new rather than std::malloc, and it
+// can't tell that operator new is the replacement above that calls std::malloc
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wmismatched-new-delete"
+#endif
+
+void operator delete(void* p) noexcept {
+    std::free(p);
+}
+
+void operator delete[](void* p) noexcept {
+    std::free(p);
+}
+
+void operator delete(void* p, std::size_t) noexcept {
+    std::free(p);
+}
+
+void operator delete[](void* p, std::size_t) noexcept {
+    std::free(p);
+}
+
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic pop
+#endif
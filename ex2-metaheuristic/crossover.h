@@ -2,200 +2,147 @@
 
 #include <shared/path_utils/PermutationPath.h>
 
-#include <algorithm>      // std::rotate
-#include <iterator>       // std::begin, std::end
-#include <unordered_set>  // std::unordered_set
-#include <utility>        // std::pair
-#include <vector>         // std::vector
+#include <algorithm>  // std::fill
+#include <cstdint>    // uint32_t
+#include <utility>    // std::pair
+#include <vector>     // std::vector
 
 #include "sampling.h"
 
 namespace crossover {
     namespace detail {
-        // Order crossover (OX).
-        // The pair of parent indexes must be sorted in ascending order.
-        template <typename T>
-        std::pair<PermutationPath<T>, PermutationPath<T>> order(
-            PermutationPath<T>& parent_1, PermutationPath<T>& parent_2,
-            std::pair<size_t, size_t> indexes_parent) noexcept {
-
-            const size_t N = parent_1.size();
-
-            const auto [x, y] = indexes_parent;
+        /**
+         * Set of the cities of a path, reused across crossovers. A city belongs to the set when
+         * its stamp equals the current one, so the set is emptied in O(1) by moving to the next
+         * stamp, and its memory is allocated only the first time it's used.
+         */
+        class CityStamps {
+            std::vector<uint32_t> stamps;
+            uint32_t current = 0;
+
+        public:
+            // Empty the set, making room for the cities in [0, n)
+            void clear(size_t n) {
+                if (this->stamps.size() < n) {
+                    this->stamps.resize(n, 0);
+                }
 
-            std::unordered_set<size_t> inserted_in_offspring_1;
-            inserted_in_offspring_1.reserve(parent_1.size());
+                // once the stamps wrap around, the old ones must be forgotten
+                if (++this->current == 0) {
+                    std::fill(this->stamps.begin(), this->stamps.end(), 0);
+                    this->current = 1;
+                }
+            }
 
-            std::unordered_set<size_t> inserted_in_offspring_2;
-            inserted_in_offspring_2.reserve(parent_2.size());
+            void insert(size_t city) noexcept {
+                this->stamps[city] = this->current;
+            }
 
-            inserted_in_offspring_1.insert(std::next(parent_1.begin(), x),
-                                           std::next(parent_1.begin(), y + 1));
+            [[nodiscard]] bool contains(size_t city) const noexcept {
+                return this->stamps[city] == this->current;
+            }
+        };
 
-            inserted_in_offspring_2.insert(std::next(parent_2.begin(), x),
-                                           std::next(parent_2.begin(), y + 1));
+        // Return the set of cities of the calling thread
+        inline CityStamps& thread_city_stamps() {
+            static thread_local CityStamps city_stamps;
+            return city_stamps;
+        }
 
-            PermutationPath<T> offspring_1(parent_1);
-            offspring_1.reset_cost();
+        // Copy the cut [x, y] of parent into offspring, then fill the other positions of
+        // offspring, from the first one, with the cities of other that aren't in the cut, in the
+        // order they appear in other from position start onwards.
+        // other is read with modular indexing, as if it were rotated to put start first.
+        template <typename T, typename Index>
+        void order_fill(const PermutationPath<T, Index>& parent,
+                        const PermutationPath<T, Index>& other, size_t x, size_t y, size_t start,
+                        PermutationPath<T, Index>& offspring) {
+            const size_t N = parent.size();
+
+            CityStamps& in_cut = thread_city_stamps();
+            in_cut.clear(N);
+
+            for (size_t i = x; i <= y; ++i) {
+                offspring[i] = parent[i];
+                in_cut.insert(parent[i]);
+            }
 
-            PermutationPath<T> offspring_2(parent_2);
-            offspring_2.reset_cost();
+            size_t i = x == 0 ? y + 1 : 0;
+            size_t j = start % N;
 
-            // Rotate parent vectors to put the cut at the end of each parent.
-            // E.g. [7 1 6 2 | 5 8 9 | 3 4] -> [3 4 7 1 6 2 | 5 8 9]
-            std::rotate(parent_1.begin(), std::next(parent_1.begin(), y + 1), parent_1.end());
-            std::rotate(parent_2.begin(), std::next(parent_2.begin(), y + 1), parent_2.end());
+            for (size_t k = 0; k < N && i < N; ++k) {
+                const Index city = other[j];
 
-            size_t i, j;
+                if (!in_cut.contains(city)) {
+                    offspring[i] = city;
 
-            auto order_helper =
-                [&i](size_t value, PermutationPath<T>& offspring,
-                     std::unordered_set<size_t>& inserted_in_offspring) mutable -> void {
-                const bool can_insert = inserted_in_offspring.count(value) == 0;
-                if (can_insert) {
-                    offspring[i] = value;
-                    ++i;
-                    inserted_in_offspring.insert(value);
+                    // skip the cut
+                    if (++i == x) {
+                        i = y + 1;
+                    }
                 }
-            };
-
-            i = 0;
-            j = 0;
-            for (; i < x; ++j) {
-                T value = parent_2[j];
-                order_helper(value, offspring_1, inserted_in_offspring_1);
-            }
 
-            i = y + 1;
-            for (; i < N && j < N; ++j) {
-                T value = parent_2[j];
-                order_helper(value, offspring_1, inserted_in_offspring_1);
-            }
-
-            i = 0;
-            j = 0;
-            for (; i < x; ++j) {
-                T value = parent_1[j];
-                order_helper(value, offspring_2, inserted_in_offspring_2);
+                if (++j == N) {
+                    j = 0;
+                }
             }
 
-            i = y + 1;
-            for (; i < N && j < N; ++j) {
-                T value = parent_1[j];
-                order_helper(value, offspring_2, inserted_in_offspring_2);
-            }
+            offspring.reset_cost();
+        }
 
-            // Reset parent rotation
-            std::rotate(parent_1.begin(), std::next(parent_1.begin(), N - y - 1), parent_1.end());
-            std::rotate(parent_2.begin(), std::next(parent_2.begin(), N - y - 1), parent_2.end());
+        // Order crossover (OX). The offsprings are written into offspring_1 and offspring_2,
+        // which must have the size of the parents.
+        // The pair of parent indexes must be sorted in ascending order.
+        template <typename T, typename Index>
+        void order(const PermutationPath<T, Index>& parent_1,
+                   const PermutationPath<T, Index>& parent_2,
+                   std::pair<size_t, size_t> indexes_parent, PermutationPath<T, Index>& offspring_1,
+                   PermutationPath<T, Index>& offspring_2) {
+            const auto [x, y] = indexes_parent;
 
-            return {PermutationPath<T>(std::move(offspring_1)),
-                    PermutationPath<T>(std::move(offspring_2))};
+            order_fill(parent_1, parent_2, x, y, y + 1, offspring_1);
+            order_fill(parent_2, parent_1, x, y, y + 1, offspring_2);
         }
 
         // Variation of Davis' order crossover (OX) with two cut pairs rather than just one.
-        // parent_1 and parent_2 might be manipulated during the execution of this function,
-        // but at the end of it they're guaranteed to be reordered to the initial configuration.
+        // The offsprings are written into offspring_1 and offspring_2, which must have the size
+        // of the parents.
         // The pairs of parent indexes must be sorted in ascending order.
         // See: https://www.redalyc.org/pdf/2652/265219618002.pdf
-        template <typename T>
-        std::pair<PermutationPath<T>, PermutationPath<T>> order_alt(
-            PermutationPath<T>& parent_1, PermutationPath<T>& parent_2,
-            std::pair<size_t, size_t> indexes_parent_1,
-            std::pair<size_t, size_t> indexes_parent_2) noexcept {
-
-            const size_t N = parent_1.size();
-
+        template <typename T, typename Index>
+        void order_alt(const PermutationPath<T, Index>& parent_1,
+                       const PermutationPath<T, Index>& parent_2,
+                       std::pair<size_t, size_t> indexes_parent_1,
+                       std::pair<size_t, size_t> indexes_parent_2,
+                       PermutationPath<T, Index>& offspring_1,
+                       PermutationPath<T, Index>& offspring_2) {
             const auto [x, y] = indexes_parent_1;
             const auto [w, z] = indexes_parent_2;
 
-            std::unordered_set<size_t> inserted_in_offspring_1;
-            inserted_in_offspring_1.reserve(parent_1.size());
-            std::unordered_set<size_t> inserted_in_offspring_2;
-            inserted_in_offspring_2.reserve(parent_2.size());
-
-            inserted_in_offspring_1.insert(std::next(parent_1.begin(), x),
-                                           std::next(parent_1.begin(), y + 1));
-
-            inserted_in_offspring_2.insert(std::next(parent_2.begin(), w),
-                                           std::next(parent_2.begin(), z + 1));
-
-            PermutationPath<T> offspring_1(parent_1);
-            offspring_1.reset_cost();
-            PermutationPath<T> offspring_2(parent_2);
-            offspring_2.reset_cost();
-
-            // Rotate parent vectors to put the cut at the end of each parent.
-            // E.g. [7 1 6 2 | 5 8 9 | 3 4] -> [3 4 7 1 6 2 | 5 8 9]
-            std::rotate(parent_1.begin(), std::next(parent_1.begin(), y + 1), parent_1.end());
-            std::rotate(parent_2.begin(), std::next(parent_2.begin(), z + 1), parent_2.end());
-
-            size_t i, j;
-
-            auto order_helper =
-                [&i](size_t value, PermutationPath<T>& offspring,
-                     std::unordered_set<size_t>& inserted_in_offspring) mutable -> void {
-                const bool can_insert = inserted_in_offspring.count(value) == 0;
-                if (can_insert) {
-                    offspring[i] = value;
-                    ++i;
-                    inserted_in_offspring.insert(value);
-                }
-            };
-
-            i = 0;
-            j = 0;
-            for (; i < x; ++j) {
-                T value = parent_2[j];
-                order_helper(value, offspring_1, inserted_in_offspring_1);
-            }
-
-            i = y + 1;
-            for (; i < N && j < N; ++j) {
-                T value = parent_2[j];
-                order_helper(value, offspring_1, inserted_in_offspring_1);
-            }
-
-            i = 0;
-            j = 0;
-            for (; i < w; ++j) {
-                T value = parent_1[j];
-                order_helper(value, offspring_2, inserted_in_offspring_2);
-            }
-
-            i = z + 1;
-            for (; i < N && j < N; ++j) {
-                T value = parent_1[j];
-                order_helper(value, offspring_2, inserted_in_offspring_2);
-            }
-
-            // Reset parent rotation
-            std::rotate(parent_1.begin(), std::next(parent_1.begin(), N - y - 1), parent_1.end());
-            std::rotate(parent_2.begin(), std::next(parent_2.begin(), N - z - 1), parent_2.end());
-
-            return {PermutationPath<T>(std::move(offspring_1)),
-                    PermutationPath<T>(std::move(offspring_2))};
+            order_fill(parent_1, parent_2, x, y, z + 1, offspring_1);
+            order_fill(parent_2, parent_1, w, z, y + 1, offspring_2);
         }
     }  // namespace detail
 
-    template <typename T, class URBG>
-    std::pair<PermutationPath<T>, PermutationPath<T>> order(PermutationPath<T>& parent_1,
-                                                            PermutationPath<T>& parent_2, size_t n,
-                                                            URBG&& random_generator) noexcept {
+    template <typename T, typename Index, class URBG>
+    void order(const PermutationPath<T, Index>& parent_1,
+               const PermutationPath<T, Index>& parent_2, PermutationPath<T, Index>& offspring_1,
+               PermutationPath<T, Index>& offspring_2, size_t n, URBG&& random_generator) {
         std::pair<size_t, size_t> cut_indexes(sampling::sample_pair<true>(1, n, random_generator));
-        return detail::order(parent_1, parent_2, cut_indexes);
+        detail::order(parent_1, parent_2, cut_indexes, offspring_1, offspring_2);
     }
 
-    template <typename T, class URBG>
-    std::pair<PermutationPath<T>, PermutationPath<T>> order_alt(PermutationPath<T>& parent_1,
-                                                                PermutationPath<T>& parent_2,
-                                                                size_t n,
-                                                                URBG&& random_generator) noexcept {
+    template <typename T, typename Index, class URBG>
+    void order_alt(const PermutationPath<T, Index>& parent_1,
+                   const PermutationPath<T, Index>& parent_2,
+                   PermutationPath<T, Index>& offspring_1, PermutationPath<T, Index>& offspring_2,
+                   size_t n, URBG&& random_generator) {
         std::pair<size_t, size_t> cut_indexes_1(
             sampling::sample_pair<true>(1, n, random_generator));
         std::pair<size_t, size_t> cut_indexes_2(
             sampling::sample_pair<true>(1, n, random_generator));
 
-        return detail::order_alt(parent_1, parent_2, cut_indexes_1, cut_indexes_2);
+        detail::order_alt(parent_1, parent_2, cut_indexes_1, cut_indexes_2, offspring_1,
+                          offspring_2);
     }
 }  // namespace crossover
@@ -1,55 +1,75 @@
 ﻿#pragma once
 
-#include <shared/DistanceMatrix.h>
+#include <shared/Distances.h>
 
-#include <unordered_set>  // std::unordered_set
-#include <vector>         // std::vector
+#include <limits>  // std::numeric_limits
+#include <vector>  // std::vector
 
 #include "utils.h"
 
 namespace heuristic {
     template <typename T>
-    std::vector<size_t> farthest_insertion(const DistanceMatrix<T>& distance_matrix) {
-        const size_t size = distance_matrix.size();
+    std::vector<size_t> farthest_insertion(const Distances<T>& distances) {
+        const size_t size = distances.size();
 
-        const auto get_distance = [&distance_matrix](const size_t x, const size_t y) -> T {
-            return distance_matrix.at(x, y);
+        const auto get_distance = [&distances](const size_t x, const size_t y) -> T {
+            return distances.at(x, y);
         };
 
-        // Keep track of the nodes not in the partial Hamiltonian circuit.
-        // Initially, none of them is in the circuit, so not_visited is initialized with
-        // every vertex from 0 to size-1
-        std::unordered_set<size_t> not_visited = utils::unordered_set_in_range(0, size);
+        const auto get_distances = [&distances](const size_t x, const size_t* first,
+                                                const size_t* last, T* out) {
+            distances.distances(x, first, last, out);
+        };
 
         // Select the 2 farthest nodes and add them to the partial circuit
-        const auto& [i, j] = distance_matrix.get_2_farthest_vertexes();
+        const auto& [i, j] = distances.get_2_farthest_vertexes();
 
         // Keep track of the nodes in the partial Hamiltonian circuit
         std::vector<size_t> circuit{i, j};
         circuit.reserve(size);
 
-        // Remove the first 2 selected nodes from not_visited
-        not_visited.erase(i);
-        not_visited.erase(j);
+        // Keep track of the length of the arc that starts from each node in circuit
+        std::vector<T> edge_lengths{get_distance(i, j), get_distance(j, i)};
+        edge_lengths.reserve(size);
 
-        // Step 2: find a node k not in circuit that maximizes δ(k, circuit)
-        const size_t r = utils::select_new_r_maximize(not_visited, circuit, get_distance);
+        // Keep track of the nodes not in the partial Hamiltonian circuit, together with their
+        // minimum distance δ(k, circuit) from the circuit. Both vectors are kept aligned, and
+        // they're updated only w.r.t. the node that is inserted at each step, so that every step
+        // takes O(n) instead of O(n^2).
+        std::vector<size_t> candidates;
+        candidates.reserve(size);
+        for (size_t k = 0; k < size; ++k) {
+            if (k != i && k != j) {
+                candidates.emplace_back(k);
+            }
+        }
 
-        // Step 3: insert r in between the two consecutive tour cities i, j for which such an
-        // insertion causes the minimum increase in total tour length.
-        circuit.emplace_back(r);
-        not_visited.erase(r);
+        std::vector<T> min_distances(candidates.size(), std::numeric_limits<T>::max());
+        static_cast<void>(utils::update_min_distances_select_farthest(candidates, min_distances,
+                                                                      i, get_distances));
+        size_t farthest = utils::update_min_distances_select_farthest(candidates, min_distances,
+                                                                      j, get_distances);
 
         // Step 4: repeat the insertion from step 2 until all nodes have been inserted into the
         // circuit
-        while (!not_visited.empty()) {
-            // Select the not visited node r that maximizes δ(r, circuit)
-            size_t new_r = utils::select_new_r_maximize(not_visited, circuit, get_distance);
-            not_visited.erase(new_r);
+        while (!candidates.empty()) {
+            // Step 2: select the not visited node r that maximizes δ(r, circuit), and remove it
+            // from the candidates in O(1)
+            const size_t r = candidates[farthest];
+            candidates[farthest] = candidates.back();
+            min_distances[farthest] = min_distances.back();
+            candidates.pop_back();
+            min_distances.pop_back();
 
-            // Find the arc (i, j) that minimizes the value of w(i, r) - w(r, j) - w(i, j)
+            // Step 3: find the arc (i, j) that minimizes the value of w(i, r) + w(r, j) - w(i, j)
             // and add r in between i and j in circuit
-            utils::perform_best_circuit_insertion(new_r, circuit, get_distance);
+            utils::perform_best_circuit_insertion(r, circuit, edge_lengths, get_distance,
+                                                  get_distances);
+
+            if (!candidates.empty()) {
+                farthest = utils::update_min_distances_select_farthest(candidates, min_distances, r,
+                                                                       get_distances);
+            }
         }
 
         // Force the solution to start from the first city, 0
@@ -2,26 +2,30 @@
 
 #include <shared/path_utils/PermutationPath.h>
 
-#include <cmath>   // std::log2
-#include <vector>  // std::vector
+#include <cmath>  // std::log2
 
+#include "LinKernighanSearch.h"
+#include "OrOptSearch.h"
+#include "PopulationPool.h"
+#include "TwoOptSearch.h"
 #include "neighborhood.h"
 
 namespace local_search {
-    template <typename T, class URBG>
-    void improve_generation_simple(std::vector<PermutationPath<T>>& population_pool,
+    template <typename T, typename Index, class URBG>
+    void improve_generation_simple(PopulationPool<T, Index>& population_pool,
                                    URBG&& random_generator) noexcept {
-        for (auto& path : population_pool) {
-            neighborhood::variable_neighborhood_descent(path, random_generator, 10);
+        for (size_t i = 0; i < population_pool.size(); ++i) {
+            neighborhood::variable_neighborhood_descent(population_pool.modify(i),
+                                                        random_generator, 10);
         }
     }
 
     // Apply variable neighborhood search to all the sequential pairs of indexes (i, j), i < j
     // of each path of the given population pool
-    template <typename T>
-    void improve_generation_complete(std::vector<PermutationPath<T>>& population_pool) {
-        for (auto& path : population_pool) {
-            neighborhood::complete_variable_neighborhood_search(path);
+    template <typename T, typename Index>
+    void improve_generation_complete(PopulationPool<T, Index>& population_pool) {
+        for (size_t i = 0; i < population_pool.size(); ++i) {
+            neighborhood::complete_variable_neighborhood_search(population_pool.modify(i));
         }
     }
 
@@ -32,10 +36,10 @@ namespace local_search {
     // ::improve_generation_complete but much faster.
     // E.g.:
     // - n: 14 => window deltas: [2, 8]
-    template <typename T, class URBG>
-    void improve_generation_greedy(std::vector<PermutationPath<T>>& population_pool,
+    template <typename T, typename Index, class URBG>
+    void improve_generation_greedy(PopulationPool<T, Index>& population_pool,
                                    URBG&& random_generator) {
-        const size_t n = population_pool[0].size();
+        const size_t n = population_pool.path_size();
         const size_t low = 1;
         const size_t high = n - 1;
 
@@ -44,11 +48,55 @@ namespace local_search {
         const size_t delta_min = static_cast<size_t>(log_threshold);
         const size_t delta_max = static_cast<size_t>(3.5 * log_threshold);
 
-        for (auto& path : population_pool) {
+        for (size_t i = 0; i < population_pool.size(); ++i) {
             std::pair<size_t, size_t> window = sampling::sample_constrained_window(
                 low, high, delta_min, delta_max, random_generator);
 
-            neighborhood::windowed_variable_neighborhood_search(path, std::move(window));
+            neighborhood::windowed_variable_neighborhood_search(population_pool.modify(i),
+                                                                std::move(window));
         }
     }
-}  // namespace local_search
\ No newline at end of file
+
+    // Apply the candidate-list driven 2-opt local search to each path of the given population
+    // pool, until each of them is a 2-opt local optimum w.r.t. its nearest neighbors.
+    template <typename T, typename Index>
+    void improve_generation_two_opt(PopulationPool<T, Index>& population_pool,
+                                    TwoOptSearch<T, Index>& two_opt) noexcept {
+        for (size_t i = 0; i < population_pool.size(); ++i) {
+            two_opt.improve(population_pool.modify(i));
+        }
+    }
+
+    // Apply the candidate-list driven 2-opt and Or-opt local searches to each path of the given
+    // population pool, alternating them until Or-opt can't improve the 2-opt local optimum.
+    template <typename T, typename Index>
+    void improve_generation_two_opt_or_opt(PopulationPool<T, Index>& population_pool,
+                                           TwoOptSearch<T, Index>& two_opt,
+                                           OrOptSearch<T, Index>& or_opt) noexcept {
+        for (size_t i = 0; i < population_pool.size(); ++i) {
+            PermutationPath<T, Index>& path = population_pool.modify(i);
+
+            do {
+                two_opt.improve(path);
+            } while (or_opt.improve(path));
+        }
+    }
+
+    // Apply the Lin-Kernighan style variable-depth search to each path of the given population
+    // pool.
+    template <typename T, typename Index>
+    void improve_generation_lin_kernighan(PopulationPool<T, Index>& population_pool,
+                                          LinKernighanSearch<T, Index>& lin_kernighan) noexcept {
+        for (size_t i = 0; i < population_pool.size(); ++i) {
+            lin_kernighan.improve(population_pool.modify(i));
+        }
+    }
+
+    // Apply the Lin-Kernighan style variable-depth search to a single path, e.g. the circuit
+    // computed by heuristic::farthest_insertion.
+    template <typename T, typename Index>
+    void lin_kernighan(PermutationPath<T, Index>& path, const NeighborLists& neighbor_lists) {
+        LinKernighanSearch<T, Index> lin_kernighan(neighbor_lists);
+        lin_kernighan.improve(path);
+    }
+}  // namespace local_search
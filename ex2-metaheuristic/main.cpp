@@ -1,10 +1,15 @@
+#include <shared/CoordinateDistances.h>
 #include <shared/DistanceMatrix.h>
+#include <shared/DistanceType.h>
+#include <shared/Distances.h>
+#include <shared/NeighborLists.h>
 #include <shared/path_utils/PermutationPath.h>
 #include <shared/read_tsp_file.h>
 #include <shared/stopwatch.h>
 
 #include <chrono>  // std::chrono
 #include <condition_variable>
+#include <cstdint>   // uint16_t, uint32_t
 #include <iostream>  // std::cerr, std::cout, std::endl
 #include <mutex>
 #include <string>  // std::stoi
@@ -13,48 +18,34 @@
 #include "MetaHeuristicsParams.h"
 #include "TSPSolver.h"
 #include "cli.h"
+#include "count_allocations.h"
+
+// Call the generic function f with the narrowest type that can store the cities of a path of n
+// cities, so that copying the paths of the population moves as few bytes as possible
+template <class Function>
+void visit_index_type(size_t n, Function&& f) {
+    if (PermutationPath<double, uint16_t>::can_store(n)) {
+        f(uint16_t());
+    } else {
+        f(uint32_t());
+    }
+}
 
-int main(int argc, char** argv) {
-    /**
-     * Handler for command-line arguments
-     */
-    auto args = cli::parse(argc, argv);
+// Solve the TSP instance read by point_reader, whose distances of type T are provided by
+// distances. The cities of each path are stored with type Index.
+template <typename T, typename Index>
+void solve(const cli::CLIArgs& args, const MetaHeuristicsParams& params,
+           const point_reader::PointReader& point_reader, Distances<T> distances) {
     std::chrono::duration timeout_ms = std::chrono::milliseconds(args.timeout_ms);
 
-    // clang-format off
-	MetaHeuristicsParams params{
-		// mutation_probability
-		args.mutation_probability,
-
-		// crossover_rate
-		args.crossover_rate,
-
-		// mu
-		args.mu,
-
-		// lambda
-		args.lambda,
-
-		// max_n_generations_without_improvement
-		args.max_gen_no_improvement,
-
-		// max_n_generations
-		args.max_gen,
-
-		// tournament_k
-		args.k
-	};
-    // clang-format on
-
-    auto point_reader(read_tsp_file(args.filename.c_str()));
-
-    const size_t N = point_reader->dimension;
-    DistanceMatrix<double> distance_matrix = point_reader->create_distance_matrix();
+    const size_t N = distances.size();
+    const NeighborLists neighbor_lists(
+        point_reader.create_neighbor_lists(distances, args.neighbors));
 
     // start the stopwatch
     const auto program_time_start = stopwatch::now();
 
-    TSPSolver<double> tsp_solver(distance_matrix, params);
+    TSPSolver<T, Index> tsp_solver(distances, neighbor_lists, params);
 
     std::mutex m;
     std::condition_variable cv;
@@ -88,10 +79,83 @@ int main(int argc, char** argv) {
     std::cout << "N: " << N << '\n';
     std::cout << "program_time_ms: " << program_time_ms << '\n';
     std::cout << "was_interrupted: " << was_interrupted << '\n';
+    std::cout << "steady_state_allocations: " << tsp_solver.get_steady_state_allocations() << '\n';
     std::cout << "Solution cost: " << std::fixed << (tsp_solver.get_best_solution())->cost()
               << '\n';
 
     if (args.show_path) {
-        std::cout << "Solution path:\n" << *(tsp_solver.get_best_solution()) << '\n';
+        // the cities are printed with the labels of the input file
+        std::cout << "Solution path:\n";
+        tsp_solver.get_best_solution()->print(
+            std::cout, [&](size_t city) { return point_reader.original_label(city); });
+        std::cout << '\n';
+    }
+}
+
+// Solve the TSP instance read by point_reader, using distances of type T stored according to the
+// layout chosen by the user
+template <typename T>
+void run(const cli::CLIArgs& args, const MetaHeuristicsParams& params,
+         point_reader::PointReader& point_reader) {
+    const auto solve_with = [&](Distances<T> distances) {
+        visit_index_type(distances.size(), [&](auto index) {
+            solve<T, decltype(index)>(args, params, point_reader, distances);
+        });
+    };
+
+    if (cli::is_coordinate_layout(args.distance_layout)) {
+        const CoordinateDistances<T> coordinate_distances =
+            point_reader.create_coordinate_distances<T>();
+        solve_with(coordinate_distances);
+    } else {
+        const DistanceMatrix<T> distance_matrix = point_reader.create_distance_matrix<T>(
+            cli::parse_distance_layout(args.distance_layout));
+        solve_with(distance_matrix);
+    }
+}
+
+int main(int argc, char** argv) {
+    /**
+     * Handler for command-line arguments
+     */
+    auto args = cli::parse(argc, argv);
+
+    // clang-format off
+	MetaHeuristicsParams params{
+		// mutation_probability
+		args.mutation_probability,
+
+		// crossover_rate
+		args.crossover_rate,
+
+		// mu
+		args.mu,
+
+		// lambda
+		args.lambda,
+
+		// max_n_generations_without_improvement
+		args.max_gen_no_improvement,
+
+		// max_n_generations
+		args.max_gen,
+
+		// tournament_k
+		args.k,
+
+		// local_search_type
+		cli::parse_local_search_type(args.local_search)
+	};
+    // clang-format on
+
+    auto point_reader(read_tsp_file(args.filename.c_str()));
+
+    if (args.hilbert) {
+        point_reader->renumber_along_hilbert_curve();
     }
+
+    // instantiate the solver with the distance type chosen by the user
+    visit_distance_type(parse_distance_type(args.distance_type), [&](auto distance) {
+        run<decltype(distance)>(args, params, *point_reader);
+    });
 }
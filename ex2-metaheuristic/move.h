@@ -0,0 +1,113 @@
+#pragma once
+
+#include <shared/path_utils/PermutationPath.h>
+
+#include <algorithm>  // std::min
+
+#include "mutation.h"
+
+namespace move {
+    // Mutation operators that can be used to move from a path to one of its neighbors
+    enum class MoveType { SWAP, LEFT_ROTATION, RIGHT_ROTATION, INVERSION, OR_OPT };
+
+    // A move is a mutation described by its type and indexes, together with the variation of
+    // the cost of the path it would cause. It can be scored and compared with other moves
+    // without copying the path it refers to.
+    // length and reversed are only meaningful for Or-opt moves.
+    template <typename T>
+    struct Move {
+        MoveType type;
+        size_t x;
+        size_t y;
+        utils::cost_t<T> delta;
+        size_t length = 1;
+        bool reversed = false;
+
+        // Return true iff applying the move would decrease the cost of the path
+        [[nodiscard]] bool is_improving() const noexcept {
+            return delta < 0;
+        }
+    };
+
+    // Return the move with the lowest delta between the two given ones.
+    // Ties are resolved in favor of the first move.
+    template <typename T>
+    [[nodiscard]] const Move<T>& best_of(const Move<T>& a, const Move<T>& b) noexcept {
+        return b.delta < a.delta ? b : a;
+    }
+
+    // Score the given move on the path in O(1), without applying it.
+    template <typename T, typename Index>
+    [[nodiscard]] Move<T> evaluate(const PermutationPath<T, Index>& path, MoveType type, size_t x,
+                                   size_t y) noexcept {
+        utils::cost_t<T> delta = 0;
+
+        switch (type) {
+        case MoveType::SWAP:
+            delta = mutation::delta::swap(path, x, y);
+            break;
+        case MoveType::LEFT_ROTATION:
+            delta = mutation::delta::left_rotation(path, x, y);
+            break;
+        case MoveType::RIGHT_ROTATION:
+            delta = mutation::delta::right_rotation(path, x, y);
+            break;
+        case MoveType::INVERSION:
+            delta = mutation::delta::inversion(path, x, y);
+            break;
+        case MoveType::OR_OPT:
+            delta = mutation::delta::or_opt(path, x, y, 1, false);
+            break;
+        }
+
+        return {type, x, y, delta};
+    }
+
+    // Score the Or-opt move of the given segment on the path in O(1), without applying it.
+    template <typename T, typename Index>
+    [[nodiscard]] Move<T> evaluate_or_opt(const PermutationPath<T, Index>& path, size_t x, size_t y,
+                                          size_t length, bool reversed) noexcept {
+        const utils::cost_t<T> delta = mutation::delta::or_opt(path, x, y, length, reversed);
+        return {MoveType::OR_OPT, x, y, delta, length, reversed};
+    }
+
+    // Score every Or-opt move that relocates a segment of 1 to max_length cities starting at
+    // index x right after index y, in both orientations, and return the best one.
+    template <typename T, typename Index>
+    [[nodiscard]] Move<T> best_or_opt(const PermutationPath<T, Index>& path, size_t x, size_t y,
+                                      size_t max_length = 3) noexcept {
+        Move<T> best_move = evaluate_or_opt(path, x, y, 1, false);
+
+        const size_t max_feasible_length = y > x ? std::min(max_length, y - x) : 0;
+
+        for (size_t length = 1; length <= max_feasible_length; ++length) {
+            for (const bool reversed : {false, true}) {
+                best_move = best_of(best_move, evaluate_or_opt(path, x, y, length, reversed));
+            }
+        }
+
+        return best_move;
+    }
+
+    // Apply the given move in place. The cost of the path is updated with the delta of the move.
+    template <typename T, typename Index>
+    void apply(PermutationPath<T, Index>& path, const Move<T>& move) noexcept {
+        switch (move.type) {
+        case MoveType::SWAP:
+            mutation::swap(path, move.x, move.y);
+            break;
+        case MoveType::LEFT_ROTATION:
+            mutation::left_rotation(path, move.x, move.y);
+            break;
+        case MoveType::RIGHT_ROTATION:
+            mutation::right_rotation(path, move.x, move.y);
+            break;
+        case MoveType::INVERSION:
+            mutation::inversion(path, move.x, move.y);
+            break;
+        case MoveType::OR_OPT:
+            mutation::or_opt(path, move.x, move.y, move.length, move.reversed);
+            break;
+        }
+    }
+}  // namespace move
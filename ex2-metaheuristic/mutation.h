@@ -2,18 +2,180 @@
 
 #include <shared/path_utils/PermutationPath.h>
 
+#include <algorithm>  // std::copy, std::copy_backward, std::sort, std::unique, std::rotate,
+                      // std::reverse
+#include <array>      // std::array
+
 namespace mutation {
+    namespace detail {
+        // Return the position that precedes i in a circuit of size n
+        [[nodiscard]] inline size_t prev(size_t i, size_t n) noexcept {
+            return i == 0 ? n - 1 : i - 1;
+        }
+
+        // Return the position that follows i in a circuit of size n
+        [[nodiscard]] inline size_t next(size_t i, size_t n) noexcept {
+            return i == n - 1 ? 0 : i + 1;
+        }
+    }  // namespace detail
+
+    /**
+     * Cost variations of the mutations, computed in O(1) without applying them.
+     * Each function returns new_cost - old_cost, considering only the handful of edges that the
+     * mutation with the same name and the same preconditions would remove and add.
+     * The distance matrix is assumed to be symmetric.
+     */
+    namespace delta {
+        template <typename T, typename Index>
+        [[nodiscard]] utils::cost_t<T> swap(const PermutationPath<T, Index>& path, size_t x,
+                                            size_t y) noexcept {
+            const size_t n = path.size();
+
+            if (x == y) {
+                return utils::cost_t<T>(0);
+            }
+
+            // city placed at position i after the swap
+            const auto after = [&](size_t i) -> size_t {
+                return i == x ? path[y] : (i == y ? path[x] : path[i]);
+            };
+
+            // the edges are identified by the position of their first endpoint. When x and y are
+            // adjacent, some of them coincide and must be counted only once.
+            std::array<size_t, 4> edges{detail::prev(x, n), x, detail::prev(y, n), y};
+            std::sort(edges.begin(), edges.end());
+            const auto edges_end = std::unique(edges.begin(), edges.end());
+
+            utils::cost_t<T> delta = 0;
+            for (auto it = edges.begin(); it != edges_end; ++it) {
+                const size_t i = *it;
+                const size_t j = detail::next(i, n);
+                delta += path.distance_between(after(i), after(j));
+                delta -= path.distance_between(path[i], path[j]);
+            }
+
+            return delta;
+        }
+
+        template <typename T, typename Index>
+        [[nodiscard]] utils::cost_t<T> left_rotation(const PermutationPath<T, Index>& path,
+                                                     size_t x, size_t y) noexcept {
+            const size_t n = path.size();
+
+            // rotating the whole circuit doesn't change its cost
+            if (x >= y || (x == 0 && y == n - 1)) {
+                return utils::cost_t<T>(0);
+            }
+
+            // path[x] is moved between path[y] and path[y + 1]
+            const size_t a = path[detail::prev(x, n)];
+            const size_t b = path[x];
+            const size_t c = path[x + 1];
+            const size_t d = path[y];
+            const size_t e = path[detail::next(y, n)];
+
+            return path.distance_between(a, c) + path.distance_between(d, b) +
+                   path.distance_between(b, e) - path.distance_between(a, b) -
+                   path.distance_between(b, c) - path.distance_between(d, e);
+        }
+
+        template <typename T, typename Index>
+        [[nodiscard]] utils::cost_t<T> right_rotation(const PermutationPath<T, Index>& path,
+                                                      size_t x, size_t y) noexcept {
+            const size_t n = path.size();
+
+            // rotating the whole circuit doesn't change its cost
+            if (x >= y || (x == 0 && y == n - 1)) {
+                return utils::cost_t<T>(0);
+            }
+
+            // path[y] is moved between path[x - 1] and path[x]
+            const size_t a = path[detail::prev(x, n)];
+            const size_t b = path[x];
+            const size_t c = path[y - 1];
+            const size_t d = path[y];
+            const size_t e = path[detail::next(y, n)];
+
+            return path.distance_between(a, d) + path.distance_between(d, b) +
+                   path.distance_between(c, e) - path.distance_between(a, b) -
+                   path.distance_between(c, d) - path.distance_between(d, e);
+        }
+
+        template <typename T, typename Index>
+        [[nodiscard]] utils::cost_t<T> inversion(const PermutationPath<T, Index>& path, size_t x,
+                                                 size_t y) noexcept {
+            const size_t n = path.size();
+
+            // reversing the whole circuit doesn't change its cost
+            if (x >= y || (x == 0 && y == n - 1)) {
+                return utils::cost_t<T>(0);
+            }
+
+            // 2-opt move: (path[x - 1], path[x]) and (path[y], path[y + 1]) are replaced by
+            // (path[x - 1], path[y]) and (path[x], path[y + 1])
+            const size_t a = path[detail::prev(x, n)];
+            const size_t b = path[x];
+            const size_t c = path[y];
+            const size_t d = path[detail::next(y, n)];
+
+            return path.distance_between(a, c) + path.distance_between(b, d) -
+                   path.distance_between(a, b) - path.distance_between(c, d);
+        }
+
+        template <typename T, typename Index>
+        [[nodiscard]] utils::cost_t<T> or_opt(const PermutationPath<T, Index>& path, size_t x,
+                                              size_t y, size_t length, bool reversed) noexcept {
+            const size_t n = path.size();
+
+            if (length == 0 || x + length > y) {
+                return utils::cost_t<T>(0);
+            }
+
+            // the segment path[x, ..., x + length - 1] is moved between path[y] and path[y + 1]
+            const size_t s_1 = path[x];
+            const size_t s_2 = path[x + length - 1];
+            const size_t c = path[y];
+            const size_t d = path[detail::next(y, n)];
+
+            if (x == 0 && y == n - 1) {
+                // the segment stays between the same cities, it can only be reversed in place
+                if (!reversed) {
+                    return utils::cost_t<T>(0);
+                }
+
+                const size_t r = path[length];
+                return path.distance_between(c, s_2) + path.distance_between(s_1, r) -
+                       path.distance_between(c, s_1) - path.distance_between(s_2, r);
+            }
+
+            const size_t p = path[detail::prev(x, n)];
+            const size_t q = path[x + length];
+
+            const utils::cost_t<T> removal_gain = path.distance_between(p, s_1) +
+                                                  path.distance_between(s_2, q) -
+                                                  path.distance_between(p, q);
+
+            const utils::cost_t<T> insertion_cost =
+                reversed ? path.distance_between(c, s_2) + path.distance_between(s_1, d)
+                         : path.distance_between(c, s_1) + path.distance_between(s_2, d);
+
+            return insertion_cost - path.distance_between(c, d) - removal_gain;
+        }
+    }  // namespace delta
+
     // Perform the swap mutation on the given path.
     // Preconditions:
     // 1) 0 <= x <= N - 1
     // 2) 0 <= y <= N - 1
     // Example:
     // swap({0,1,2,3,4,5}, 1, 4) => {0,4,2,3,1,5}
-    template <typename T>
-    inline void swap(PermutationPath<T>& path, size_t x, size_t y) noexcept {
+    template <typename T, typename Index>
+    inline void swap(PermutationPath<T, Index>& path, size_t x, size_t y) noexcept {
+        const auto cost_delta = delta::swap(path, x, y);
+
         using std::swap;
         swap(path[x], path[y]);
-        path.reset_cost();
+        path.update_cost(cost_delta);
     }
 
     // Perform the left-rotation mutation on the given path.
@@ -23,12 +185,14 @@ namespace mutation {
     // 3) x < y
     // Example:
     // left_rotation({0,1,2,3,4,5}, 1, 4) => {0,2,3,4,1,5}
-    template <typename T>
-    inline void left_rotation(PermutationPath<T>& path, size_t x, size_t y) noexcept {
-        size_t left = path[x];
+    template <typename T, typename Index>
+    inline void left_rotation(PermutationPath<T, Index>& path, size_t x, size_t y) noexcept {
+        const auto cost_delta = delta::left_rotation(path, x, y);
+
+        const Index left = path[x];
         std::copy(path.begin() + x + 1, path.begin() + y + 1, path.begin() + x);
         path[y] = left;
-        path.reset_cost();
+        path.update_cost(cost_delta);
     }
 
     // Perform the right-rotation mutation on the given path.
@@ -38,12 +202,14 @@ namespace mutation {
     // 3) x < y
     // Example:
     // right_rotation({0,1,2,3,4,5}, 1, 4) => {0,4,1,2,3,5}
-    template <typename T>
-    inline void right_rotation(PermutationPath<T>& path, size_t x, size_t y) noexcept {
-        size_t right = path[y];
-        std::copy(path.begin() + x, path.begin() + y, path.begin() + x + 1);
+    template <typename T, typename Index>
+    inline void right_rotation(PermutationPath<T, Index>& path, size_t x, size_t y) noexcept {
+        const auto cost_delta = delta::right_rotation(path, x, y);
+
+        const Index right = path[y];
+        std::copy_backward(path.begin() + x, path.begin() + y, path.begin() + y + 1);
         path[x] = right;
-        path.reset_cost();
+        path.update_cost(cost_delta);
     }
 
     // Perform the inversion mutation on the given path, aka a 2-opt move.
@@ -53,8 +219,10 @@ namespace mutation {
     // 2) 0 <= y <= N - 1
     // Example:
     // inversion({0,1,2,3,4,5}, 1, 4) => {0,4,3,2,1,5}
-    template <typename T>
-    inline void inversion(PermutationPath<T>& path, size_t x, size_t y) noexcept {
+    template <typename T, typename Index>
+    inline void inversion(PermutationPath<T, Index>& path, size_t x, size_t y) noexcept {
+        const auto cost_delta = delta::inversion(path, x, y);
+
         size_t i = x;
         size_t j = y;
 
@@ -65,6 +233,29 @@ namespace mutation {
             --j;
         }
 
-        path.reset_cost();
+        path.update_cost(cost_delta);
+    }
+
+    // Perform the Or-opt mutation on the given path: the segment of length cities starting at
+    // index x is moved right after index y, optionally reversing it.
+    // Preconditions:
+    // 1) 0 <= x <= N - 1
+    // 2) 0 <= y <= N - 1
+    // 3) x + length <= y
+    // Example:
+    // or_opt({0,1,2,3,4,5}, 1, 4, 2, false) => {0,3,4,1,2,5}
+    // or_opt({0,1,2,3,4,5}, 1, 4, 2, true) => {0,3,4,2,1,5}
+    template <typename T, typename Index>
+    inline void or_opt(PermutationPath<T, Index>& path, size_t x, size_t y, size_t length,
+                       bool reversed) noexcept {
+        const auto cost_delta = delta::or_opt(path, x, y, length, reversed);
+
+        std::rotate(path.begin() + x, path.begin() + x + length, path.begin() + y + 1);
+
+        if (reversed) {
+            std::reverse(path.begin() + y + 1 - length, path.begin() + y + 1);
+        }
+
+        path.update_cost(cost_delta);
     }
 }  // namespace mutation
@@ -2,29 +2,21 @@
 
 #include <shared/path_utils/PermutationPath.h>
 
-#include <algorithm>
-#include <vector>
+#include <algorithm>  // std::min_element
+#include <array>      // std::array
 
-#include "mutation.h"
+#include "move.h"
 #include "sampling.h"
 
 namespace neighborhood {
     namespace detail {
-        // Find the best neighbor of a given path using mutation strategies.
-        // Get indexes is a closure (a function that returns a function) used to retrieve the pair
-        // of mutation indexes.
-        template <typename T, class GetIndexes>
-        PermutationPath<T> find_best_neighbor(const PermutationPath<T>& path,
-                                              GetIndexes&& get_indexes) noexcept {
-            // Boolean comparator used for the PermutationPath<T>* objects.
-            const auto comparator = [](auto path_a, auto path_b) -> bool {
-                return path_a->cost() > path_b->cost();
-            };
-
-            PermutationPath<T> path_swap(path);
-            PermutationPath<T> path_left_rotation(path);
-            PermutationPath<T> path_right_rotation(path);
-            PermutationPath<T> path_inversion(path);
+        // Find the best move from a given path among the mutation strategies, without copying
+        // the path. Get indexes is a closure (a function that returns a function) used to
+        // retrieve the pair of mutation indexes.
+        template <typename T, typename Index, class GetIndexes>
+        move::Move<T> find_best_neighbor(const PermutationPath<T, Index>& path,
+                                         GetIndexes&& get_indexes) noexcept {
+            using move::MoveType;
 
             const auto get_indexes_partial = get_indexes();
 
@@ -32,34 +24,31 @@ namespace neighborhood {
             const auto [i_left_rotation, j_left_rotation] = get_indexes_partial();
             const auto [i_right_rotation, j_right_rotation] = get_indexes_partial();
             const auto [i_inversion, j_inversion] = get_indexes_partial();
-
-            mutation::swap(path_swap, i_swap, j_swap);
-            mutation::left_rotation(path_left_rotation, i_left_rotation, j_left_rotation);
-            mutation::right_rotation(path_right_rotation, i_right_rotation, j_right_rotation);
-            mutation::inversion(path_inversion, i_inversion, j_inversion);
+            const auto [i_or_opt, j_or_opt] = get_indexes_partial();
 
             // clang-format off
-            std::vector<PermutationPath<T>*> candidates{
-                &path_swap,
-				&path_left_rotation,
-                &path_right_rotation,
-                &path_inversion
+            const std::array<move::Move<T>, 5> candidates{
+                move::evaluate(path, MoveType::SWAP, i_swap, j_swap),
+                move::evaluate(path, MoveType::LEFT_ROTATION, i_left_rotation, j_left_rotation),
+                move::evaluate(path, MoveType::RIGHT_ROTATION, i_right_rotation, j_right_rotation),
+                move::evaluate(path, MoveType::INVERSION, i_inversion, j_inversion),
+                move::best_or_opt(path, i_or_opt, j_or_opt)
             };
             // clang-format on
 
-            auto it = std::min_element(candidates.cbegin(), candidates.cend(), comparator);
-            const PermutationPath<T>* best_path_ptr = *it;
-            return *best_path_ptr;
+            return *std::min_element(
+                candidates.cbegin(), candidates.cend(),
+                [](const auto& a, const auto& b) -> bool { return a.delta < b.delta; });
         }
 
-        // Given a path and its best neighbor, it updates the path if its cost is higher than its
-        // best neighbor's cost.
-        template <typename T>
-        void change_neighborhood(PermutationPath<T>& path, PermutationPath<T>&& best_neighbor,
+        // Given a path and its best neighboring move, it applies the move in place if it
+        // decreases the cost of the path.
+        template <typename T, typename Index>
+        void change_neighborhood(PermutationPath<T, Index>& path, const move::Move<T>& best_move,
                                  size_t& k) noexcept {
-            if (best_neighbor.cost() < path.cost()) {
+            if (best_move.is_improving()) {
                 // make a move
-                path = std::move(best_neighbor);
+                move::apply(path, best_move);
 
                 // initial neighborhood
                 k = 0;
@@ -70,8 +59,8 @@ namespace neighborhood {
         }
     }  // namespace detail
 
-    template <typename T, class URBG>
-    void variable_neighborhood_descent(PermutationPath<T>& path, URBG&& random_generator,
+    template <typename T, typename Index, class URBG>
+    void variable_neighborhood_descent(PermutationPath<T, Index>& path, URBG&& random_generator,
                                        size_t k_max = 3) noexcept {
         const size_t n = path.size();
 
@@ -90,37 +79,32 @@ namespace neighborhood {
 
         size_t k = 0;
         while (k < k_max) {
-            PermutationPath<T>&& best_neighbor(
-                detail::find_best_neighbor(path, get_indexes_static));
-            detail::change_neighborhood(path, std::move(best_neighbor), k);
+            const auto best_move = detail::find_best_neighbor(path, get_indexes_static);
+            detail::change_neighborhood(path, best_move, k);
         }
     }
 
-    template <typename T>
-    void complete_variable_neighborhood_search(PermutationPath<T>& path) noexcept {
+    template <typename T, typename Index>
+    void complete_variable_neighborhood_search(PermutationPath<T, Index>& path) noexcept {
         const size_t n = path.size();
-        T best_cost = path.cost();
 
         for (size_t i = 0; i < n - 1; ++i) {
             for (size_t j = i + 1; j < n; ++j) {
                 const auto get_indexes = [=]() {
                     return [=]() -> std::pair<size_t, size_t> { return {i, j}; };
                 };
-                auto&& best_neighbor = detail::find_best_neighbor(path, get_indexes);
+                const auto best_move = detail::find_best_neighbor(path, get_indexes);
 
-                if (best_cost > best_neighbor.cost()) {
-                    best_cost = best_neighbor.cost();
-                    path = std::move(best_neighbor);
+                if (best_move.is_improving()) {
+                    move::apply(path, best_move);
                 }
             }
         }
     }
 
-    template <typename T>
-    void windowed_variable_neighborhood_search(PermutationPath<T>& path,
+    template <typename T, typename Index>
+    void windowed_variable_neighborhood_search(PermutationPath<T, Index>& path,
                                                std::pair<size_t, size_t>&& window) noexcept {
-        T best_cost = path.cost();
-
         const auto [lb, ub] = window;
 
         for (size_t i = lb; i < ub - 1; ++i) {
@@ -128,11 +112,10 @@ namespace neighborhood {
                 const auto get_indexes = [=]() {
                     return [=]() -> std::pair<size_t, size_t> { return {i, j}; };
                 };
-                auto&& best_neighbor = detail::find_best_neighbor(path, get_indexes);
+                const auto best_move = detail::find_best_neighbor(path, get_indexes);
 
-                if (best_cost > best_neighbor.cost()) {
-                    best_cost = best_neighbor.cost();
-                    path = std::move(best_neighbor);
+                if (best_move.is_improving()) {
+                    move::apply(path, best_move);
                 }
             }
         }
@@ -3,43 +3,42 @@
 #include <shared/path_utils/PermutationPath.h>
 
 #include <algorithm>  // std::shuffle
-#include <vector>     // std::vector
+
+#include "PopulationPool.h"
 
 namespace population {
     namespace detail {
         // Generate random feasible solutions until the population pool reaches size μ.
         // Each feasible solution is generated permutating a given seed path at random.
-        template <typename T, class URBG>
-        inline void generate_random(std::vector<PermutationPath<T>>& population_pool,
-                                    const PermutationPath<T>& seed_path, size_t mu,
+        template <typename T, typename Index, class URBG>
+        inline void generate_random(PopulationPool<T, Index>& population_pool,
+                                    const PermutationPath<T, Index>& seed_path, size_t mu,
                                     URBG&& random_generator) noexcept {
 
             while (population_pool.size() < mu) {
-                // create a new feasible solution and randomly shuffle it
-                PermutationPath<T> candidate_path(seed_path);
+                // add a new feasible solution to the population pool and randomly shuffle it
+                population_pool.push_back(seed_path);
+
+                PermutationPath<T, Index>& candidate_path =
+                    population_pool.modify(population_pool.size() - 1);
                 candidate_path.reset_cost();
 
                 std::shuffle(candidate_path.begin() + 1, candidate_path.end(), random_generator);
-
-                // add the new candidate path to the population pool
-                population_pool.emplace_back(candidate_path);
             }
         }
     }  // namespace detail
 
     // Generate the initial population of feasible solutions until the population pool reaches size
     // μ. Each path in the population has size n, with cities represented as numbers in [0, n-1].
-    // The population is composed of random permutations of a given heuristic path.
-    template <typename T, class URBG>
-    std::vector<PermutationPath<T>> generate_initial(const PermutationPath<T>& heuristic_path,
-                                                     size_t mu, URBG&& random_generator) noexcept {
-        std::vector<PermutationPath<T>> population_pool;
-        population_pool.reserve(mu);
-        population_pool.emplace_back(heuristic_path);
+    // The population is composed of random permutations of a given heuristic path, and it's
+    // stored in the given empty population pool.
+    template <typename T, typename Index, class URBG>
+    void generate_initial(const PermutationPath<T, Index>& heuristic_path,
+                          PopulationPool<T, Index>& population_pool, size_t mu,
+                          URBG&& random_generator) noexcept {
+        population_pool.push_back(heuristic_path);
 
         // Generate random feasible solutions until the population pool reaches size μ.
         detail::generate_random(population_pool, heuristic_path, mu, random_generator);
-
-        return population_pool;
     }
 }  // namespace population
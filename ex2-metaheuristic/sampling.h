@@ -1,49 +1,61 @@
 #pragma once
 
-#include <priority_queue/PriorityQueue.h>
-
-#include <algorithm>      // std::transform, std::generate
-#include <iterator>       // std::back_inserter
-#include <random>         // std::uniform_int_distribution, std::uniform_real_distribution
-#include <unordered_set>  // std::unordered_set
-#include <vector>         // std::vector
+#include <algorithm>   // std::find, std::nth_element, std::*_heap
+#include <cmath>       // std::log, std::exp
+#include <functional>  // std::greater
+#include <iterator>    // std::distance, std::prev
+#include <random>      // std::geometric_distribution, std::uniform_*_distribution
+#include <utility>     // std::pair
+#include <vector>      // std::vector
 
 #include "utils.h"
 
 namespace sampling {
-    // Sample k distinct indexes from [low, ..., high), k < high.
-    // It implements Robert Floyd's algorithm for sampling without replacement.
+    // Sample k distinct indexes from [low, ..., high), k <= high - low, and write them to the range
+    // that starts at out. Return the end of the written range.
+    // It implements Robert Floyd's algorithm for sampling without replacement. The indexes sampled
+    // so far are searched linearly in the written range, so it suits a small k, e.g. the size of
+    // a tournament, and it doesn't allocate any memory.
     // See: https://www.nowherenearithaca.com/2013/05/robert-floyds-tiny-and-beautiful.html
-    template <class URBG>
-    std::unordered_set<size_t> sample_indexes(size_t low, size_t high, size_t k,
-                                              URBG&& random) noexcept {
+    template <class RandomIt, class URBG>
+    RandomIt sample_indexes(size_t low, size_t high, size_t k, RandomIt out,
+                            URBG&& random) noexcept {
         using distr_t = std::uniform_int_distribution<size_t>;
         using param_t = typename distr_t::param_type;
         distr_t distribution;
 
-        std::unordered_set<size_t> indexes_set;
-        indexes_set.reserve(k);
+        RandomIt last = out;
 
         for (size_t i = high - k; i < high; ++i) {
             const size_t v = distribution(random, param_t(low, i));
 
-            // If v is new, add it. If v i already in indexes_set, add i, which definitely isn't
-            // in indexes_set. In fact it's the first iteration of the loop that we could have
+            // If v is new, add it. If v is already in the sample, add i, which definitely isn't
+            // in the sample. In fact it's the first iteration of the loop that we could have
             // picked up a value that big.
-            if (!indexes_set.insert(v).second) {
-                indexes_set.insert(i);
-            }
+            *last = std::find(out, last, v) == last ? v : i;
+            ++last;
         }
 
-        return indexes_set;
+        return last;
     }
 
+    // Sample 2 distinct indexes from [low, ..., high), high - low >= 2, with uniform probability.
+    // The second index is drawn from the high - low - 1 indexes other than the first one, so
+    // exactly two numbers are drawn.
+    // If Sort is true, the indexes are returned in ascending order.
     template <bool Sort, class URBG>
     std::pair<size_t, size_t> sample_pair(size_t low, size_t high, URBG&& random) noexcept {
-        std::unordered_set<size_t> indexes_set(sample_indexes(low, high, 2, random));
+        using distr_t = std::uniform_int_distribution<size_t>;
+        using param_t = typename distr_t::param_type;
+        distr_t distribution;
+
+        size_t i = distribution(random, param_t(low, high - 1));
+        size_t j = distribution(random, param_t(low, high - 2));
 
-        size_t i = utils::pop(indexes_set);
-        size_t j = utils::pop(indexes_set);
+        // skip i, so that j is uniformly distributed over the other indexes
+        if (j >= i) {
+            ++j;
+        }
 
         if constexpr (Sort) {
             if (j < i) {
@@ -55,48 +67,39 @@ namespace sampling {
         return {i, j};
     }
 
-    // Sample k distinct elements from the elements in range [first, last].
-    // Before picking the elements, apply the unary function map_f.
-    template <class RandomIt, class URBG, class UnaryF>
-    auto sample_from_range(RandomIt first, RandomIt last, size_t k, URBG&& random, UnaryF&& map_f) {
-        using result_t = decltype(map_f(*first));
-
-        size_t n = std::distance(first, last);
-
-        std::vector<result_t> sample_values;
-        sample_values.reserve(k);
+    // Select each index of [low, ..., high) independently with the given probability, and store
+    // the selected indexes in ascending order in indexes.
+    // Rather than drawing a Bernoulli trial per index, the gaps between consecutive selected
+    // indexes are drawn from a geometric distribution, so the number of random draws is
+    // proportional to the number of selected indexes.
+    template <class URBG>
+    void sample_bernoulli_indexes(size_t low, size_t high, double probability,
+                                  std::vector<size_t>& indexes, URBG&& random) {
+        indexes.clear();
 
-        for (auto i : sample_indexes(0, n, k, random)) {
-            const auto v = std::next(first, i);
-            sample_values.emplace_back(map_f(*v));
+        if (probability <= 0) {
+            return;
         }
 
-        return sample_values;
-    }
-
-    // Sample k distinct elements from the elements in range [first, last].
-    template <class RandomIt, class URBG>
-    auto sample_from_range(RandomIt first, RandomIt last, size_t k, URBG&& random) {
-        const auto id = [](const auto& x) { return x; };
-        return sample_from_range<RandomIt, URBG>(first, last, k, random, id);
-    }
-
-    // Compute probabilities sampled from a uniform distribution
-    template <class RandomIt, class URBG>
-    std::vector<double> sample_probabilities(RandomIt first, RandomIt last, URBG&& g) {
-        size_t n = std::distance(first, last);
+        if (probability >= 1) {
+            for (size_t i = low; i < high; ++i) {
+                indexes.push_back(i);
+            }
+            return;
+        }
 
-        std::vector<double> probabilities;
-        probabilities.reserve(n);
+        // number of unselected indexes before the next selected one
+        std::geometric_distribution<size_t> gap_distribution(probability);
 
-        using distr_t = std::uniform_real_distribution<double>;
-        using param_t = typename distr_t::param_type;
-        distr_t distribution;
-
-        std::transform(first, last, std::back_inserter(probabilities),
-                       [&](auto &&) -> double { return distribution(g, param_t(0, 1)); });
+        for (size_t i = low; i < high; ++i) {
+            const size_t gap = gap_distribution(random);
+            if (gap >= high - i) {
+                break;
+            }
 
-        return probabilities;
+            i += gap;
+            indexes.push_back(i);
+        }
     }
 
     template <class URBG>
@@ -132,59 +135,121 @@ namespace sampling {
         return {a_1, a_2};
     }
 
-    // Sample k elements with replacement from a data vector according to the given discrete range
-    // of probabilities.
-    template <typename T, class RandomIt, class URBG>
-    std::vector<T> sample_from_probabilities(const std::vector<T>& data, size_t k, RandomIt first,
-                                             RandomIt last, URBG&& random_generator) noexcept {
-        std::discrete_distribution<size_t> distribution(first, last);
+    namespace detail {
+        // Weighted sample of m of the n weights in [first, last) with the A-ExpJ algorithm of
+        // Efraimidis and Spirakis, stored in the first m keys as pairs (log key, index), with
+        // keys.size() >= m. A reservoir of the m largest keys log(r) / w is kept as a min-heap,
+        // and instead of drawing a key for every weight, the algorithm draws how much weight to
+        // skip before the next item that enters the reservoir.
+        // See: https://arxiv.org/abs/1012.0256
+        template <class RandomIt, class URBG>
+        void exponential_jumps_sample(RandomIt first, RandomIt last, size_t m,
+                                      std::vector<std::pair<double, size_t>>& keys,
+                                      URBG&& random_generator) {
+            using distr_t = std::uniform_real_distribution<double>;
+            using param_t = typename distr_t::param_type;
+            distr_t distribution;
+
+            // uniform random number in (0, 1], whose logarithm is finite
+            const auto random = [&]() {
+                return 1.0 - distribution(random_generator, param_t(0, 1));
+            };
+
+            const auto reservoir_first = keys.begin();
+            const auto reservoir_last = keys.begin() + m;
+            const auto greater = std::greater<std::pair<double, size_t>>();
+
+            const size_t n = std::distance(first, last);
+
+            for (size_t i = 0; i < m; ++i) {
+                keys[i] = {std::log(random()) / first[i], i};
+            }
+            std::make_heap(reservoir_first, reservoir_last, greater);
 
-        std::vector<size_t> indexes(k);
-        std::generate(indexes.begin(), indexes.end(),
-                      [&]() { return distribution(random_generator); });
+            // weight to skip before the next item that enters the reservoir
+            double jump = std::log(random()) / reservoir_first->first;
 
-        std::vector<T> selection;
-        selection.reserve(k);
+            for (size_t i = m; i < n; ++i) {
+                const double weight = first[i];
+                jump -= weight;
 
-        std::transform(indexes.begin(), indexes.end(), std::back_inserter(selection),
-                       [&data](size_t index) { return data[index]; });
+                if (jump <= 0) {
+                    // the key of the new item is larger than the smallest key of the reservoir
+                    const double threshold = std::exp(weight * reservoir_first->first);
+                    const double r = distribution(random_generator, param_t(threshold, 1));
 
-        return selection;
-    }
+                    std::pop_heap(reservoir_first, reservoir_last, greater);
+                    *std::prev(reservoir_last) = {std::log(r) / weight, i};
+                    std::push_heap(reservoir_first, reservoir_last, greater);
 
-    // Given a vector of probabilities of being removed, return the indexes of the k sampled items.
+                    jump = std::log(random()) / reservoir_first->first;
+                }
+            }
+        }
+    }  // namespace detail
+
+    // Given the probabilities in [first, last) of the items of being removed, return the indexes
+    // of the k sampled items, i.e. the items that are kept, in no particular order, in indexes.
+    // The removed items are a weighted sample without replacement of the other n - k items
+    // (Efraimidis-Spirakis): each item is given the key log(r) / probability, with r uniform in
+    // (0, 1], and the k items with the smallest keys are kept. When few items are removed out of
+    // many, the removed ones are sampled with exponential jumps, which draws O((n - k) log(n /
+    // (n - k))) random numbers rather than n.
+    // keys is a buffer reused across calls.
     // See: http://www.sciencedirect.com/science/article/pii/S002001900500298X
-    template <class ForwardIt, class URBG>
-    std::vector<size_t> weighted_sample_indexes(ForwardIt first, ForwardIt last, size_t k,
-                                                URBG&& random_generator) {
+    template <class RandomIt, class URBG>
+    void weighted_sample_indexes(RandomIt first, RandomIt last, size_t k,
+                                 std::vector<size_t>& indexes,
+                                 std::vector<std::pair<double, size_t>>& keys,
+                                 URBG&& random_generator) {
+        // the exponential jumps are used when less than 1 item out of JUMPS_RATIO is removed
+        constexpr size_t JUMPS_RATIO = 8;
+
         const size_t n = std::distance(first, last);
+        const size_t m = n - std::min(k, n);
+
+        indexes.clear();
+        keys.resize(n);
+
+        if (m == 0) {
+            for (size_t i = 0; i < n; ++i) {
+                indexes.push_back(i);
+            }
+            return;
+        }
 
-        std::vector<size_t> indexes(utils::vector_in_range(0, n));
+        if (m * JUMPS_RATIO < n) {
+            detail::exponential_jumps_sample(first, last, m, keys, random_generator);
 
-        std::vector<double> random_weights;
-        random_weights.reserve(n);
+            // keep the items that aren't in the sample of the removed ones
+            std::sort(keys.begin(), keys.begin() + m,
+                      [](const auto& a, const auto& b) { return a.second < b.second; });
+
+            auto removed = keys.cbegin();
+            for (size_t i = 0; i < n; ++i) {
+                if (removed != keys.cbegin() + m && removed->second == i) {
+                    ++removed;
+                } else {
+                    indexes.push_back(i);
+                }
+            }
+            return;
+        }
 
         using distr_t = std::uniform_real_distribution<double>;
         using param_t = typename distr_t::param_type;
         distr_t distribution;
 
-        for (auto it = first; it != last; ++it) {
-            double r = distribution(random_generator, param_t(0, 1));
-            auto probability = *it;
-            double random_weight = std::log(r) / probability;
-            random_weights.push_back(random_weight);
+        for (size_t i = 0; i < n; ++i) {
+            const double r = 1.0 - distribution(random_generator, param_t(0, 1));
+            keys[i] = {std::log(r) / first[i], i};
         }
 
-        auto min_pq(priority_queue::make_min_priority_queue(random_weights, indexes));
-
-        std::vector<size_t> sample_indexes;
-        sample_indexes.reserve(k);
+        // the k smallest keys are moved before the k-th one
+        std::nth_element(keys.begin(), keys.begin() + k, keys.end());
 
         for (size_t i = 0; i < k; ++i) {
-            sample_indexes.push_back(min_pq.top());
-            min_pq.pop();
+            indexes.push_back(keys[i].second);
         }
-
-        return sample_indexes;
     }
 }  // namespace sampling
\ No newline at end of file
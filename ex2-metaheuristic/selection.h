@@ -1,128 +1,173 @@
 ﻿#pragma once
 
-#include <priority_queue/PriorityQueue.h>
 #include <shared/path_utils/PermutationPath.h>
 
-#include <algorithm>  // std::accumulate
+#include <algorithm>  // std::partial_sort
 #include <cmath>      // std::exp
+#include <numeric>    // std::iota
+#include <utility>    // std::pair
 #include <vector>     // std::vector
 
+#include "AliasTable.h"
+#include "PopulationPool.h"
 #include "sampling.h"
 
 namespace selection {
     namespace parent {
-        namespace detail {
-            // Compute exponential ranking probabilities
-            inline std::vector<double> exponential_ranking_probabilities(size_t mu) noexcept {
-                std::vector<double> probabilities_by_rank(mu);
-
-                // c is the normalization factor
-                double c = 0.0;
-
-                for (int rank = 0; rank < mu; ++rank) {
-                    double probability = (1.0 - std::exp(-rank));
-                    probabilities_by_rank[rank] = probability;
-                    c += probability;
-                }
+        // Compute exponential ranking probabilities. They only depend on μ, so they can be
+        // computed once and reused at every generation.
+        inline std::vector<double> exponential_ranking_probabilities(size_t mu) noexcept {
+            std::vector<double> probabilities_by_rank(mu);
 
-                // normalize probabilities
-                for (double& probability : probabilities_by_rank) {
-                    probability /= c;
-                }
+            // c is the normalization factor
+            double c = 0.0;
 
-                return probabilities_by_rank;
+            for (int rank = 0; rank < mu; ++rank) {
+                double probability = (1.0 - std::exp(-rank));
+                probabilities_by_rank[rank] = probability;
+                c += probability;
             }
-        }  // namespace detail
 
-        // Tournament selection implementation. It selects λ members from a pool of individuals.
-        template <typename T, class URBG>
-        std::vector<PermutationPath<T>> tournament(std::vector<PermutationPath<T>>& population_pool,
-                                                   size_t lambda, size_t k,
-                                                   URBG&& random_generator) noexcept {
-            std::vector<PermutationPath<T>> selection_pool;
-            selection_pool.reserve(lambda);
+            // normalize probabilities
+            for (double& probability : probabilities_by_rank) {
+                probability /= c;
+            }
 
-            // Boolean comparator used for the PermutationPath<T>* objects in heap::BinaryHeap.
-            const auto comparator = [](auto path_a, auto path_b) -> bool {
-                return path_a->cost() > path_b->cost();
-            };
+            return probabilities_by_rank;
+        }
 
-            // Map an element to the pointer to that element
-            const auto to_pointer = [](auto& x) { return &x; };
+        /**
+         * Exponential ranking distribution over the ranks of μ individuals. It only depends on μ,
+         * so it's built once per run, and a rank is sampled in O(1) with a Walker alias table.
+         * The probabilities of the highest ranks are equal up to the precision of a double, so the
+         * individuals of those ranks are interchangeable: only the lowest ranks need ordering.
+         */
+        class ExponentialRanking {
+            AliasTable rank_distribution;
+
+            // the ranks from n_ordered_ranks onwards all have the same probability
+            size_t n_ordered_ranks;
+
+            explicit ExponentialRanking(const std::vector<double>& probabilities_by_rank) :
+                rank_distribution(probabilities_by_rank.cbegin(), probabilities_by_rank.cend()),
+                n_ordered_ranks(probabilities_by_rank.size()) {
+                // the probabilities increase with the rank
+                while (this->n_ordered_ranks > 0 &&
+                       probabilities_by_rank[this->n_ordered_ranks - 1] ==
+                           probabilities_by_rank.back()) {
+                    --this->n_ordered_ranks;
+                }
+            }
+
+        public:
+            explicit ExponentialRanking(size_t mu) :
+                ExponentialRanking(exponential_ranking_probabilities(mu)) {
+            }
+
+            // Return the number of the lowest ranks whose individuals must be told apart
+            [[nodiscard]] size_t get_n_ordered_ranks() const noexcept {
+                return this->n_ordered_ranks;
+            }
+
+            // Sample a rank in [0, μ)
+            template <class URBG>
+            [[nodiscard]] size_t operator()(URBG&& random_generator) const noexcept {
+                return this->rank_distribution(random_generator);
+            }
+        };
+
+        // Tournament selection implementation. It selects λ members from a pool of individuals,
+        // and stores them in the given empty selection pool.
+        // candidates is a buffer reused across generations.
+        template <typename T, typename Index, class URBG>
+        void tournament(const PopulationPool<T, Index>& population_pool,
+                        PopulationPool<T, Index>& selection_pool, size_t lambda, size_t k,
+                        std::vector<size_t>& candidates, URBG&& random_generator) noexcept {
+            const size_t mu = population_pool.size();
+            candidates.resize(k);
 
             while (selection_pool.size() < lambda) {
                 // 1) pick k random individuals from k distinct indexes with uniform probability,
                 // with replacement. 2) compare these k individuals and select the best. 3) add the
                 // best to the mating pool. 4) continue until λ parents have been selected
 
-                auto candidates(sampling::sample_from_range(population_pool.begin(),
-                                                            population_pool.end(), k,
-                                                            random_generator, to_pointer));
-
-                heap::BinaryHeap<PermutationPath<T>*> min_heap(std::move(candidates), comparator);
+                sampling::sample_indexes(0, mu, k, candidates.begin(), random_generator);
 
                 // The best candidate has the minimum cost among the k candidates considered in the
                 // current tournament extraction.
-                PermutationPath<T>* best_candidate = min_heap.top();
+                size_t best_candidate = candidates.front();
+                for (size_t i : candidates) {
+                    if (population_pool.cost(i) < population_pool.cost(best_candidate)) {
+                        best_candidate = i;
+                    }
+                }
 
-                selection_pool.push_back(*best_candidate);
+                // the winner is shared with the population pool rather than copied
+                selection_pool.push_back(population_pool, best_candidate);
             }
-
-            return selection_pool;
         }
 
-        // Exponential ranking selection implementation. It selects λ members from a pool of
-        // individuals.
-        template <typename T, class URBG>
-        std::vector<PermutationPath<T>> ranking(std::vector<PermutationPath<T>>& population_pool,
-                                                size_t lambda, URBG&& random_generator) noexcept {
-            // The most expensive path has rank 0, the less expensive has rank mu-1
-            std::sort(
-                population_pool.begin(), population_pool.end(),
-                [](auto&& path_a, auto&& path_b) -> bool { return path_a.cost() > path_b.cost(); });
-
+        // Exponential ranking selection implementation. It selects λ members from a pool of μ
+        // individuals, and stores them in the given empty selection pool.
+        // ranking is the exponential ranking distribution of μ individuals, while by_rank is a
+        // buffer reused across generations.
+        template <typename T, typename Index, class URBG>
+        void ranking(const PopulationPool<T, Index>& population_pool,
+                     PopulationPool<T, Index>& selection_pool, size_t lambda,
+                     const ExponentialRanking& ranking, std::vector<size_t>& by_rank,
+                     URBG&& random_generator) noexcept {
             const size_t mu = population_pool.size();
 
-            /**
-             * Compute exponential ranking probabilities
-             */
-
-            std::vector<double> probabilities_by_rank(
-                detail::exponential_ranking_probabilities(mu));
+            // The most expensive path has rank 0, the less expensive has rank mu-1.
+            // The paths are ranked through their indexes, so that they're never moved.
+            // Only the lowest ranks are sorted, since the other ones are equally likely.
+            by_rank.resize(mu);
+            std::iota(by_rank.begin(), by_rank.end(), 0);
+            std::partial_sort(by_rank.begin(), by_rank.begin() + ranking.get_n_ordered_ranks(),
+                              by_rank.end(), [&population_pool](size_t a, size_t b) -> bool {
+                                  return population_pool.cost(a) > population_pool.cost(b);
+                              });
 
             /**
              * Select from population pool according to the ranking probabilities,
              * with replacement.
              */
 
-            return sampling::sample_from_probabilities(
-                population_pool, lambda, probabilities_by_rank.cbegin(),
-                probabilities_by_rank.cend(), random_generator);
+            for (size_t i = 0; i < lambda; ++i) {
+                selection_pool.push_back(population_pool, by_rank[ranking(random_generator)]);
+            }
         }
     }  // namespace parent
 
     namespace children {
+        // Buffers of generational_mu_lambda_selection, reused across generations
+        struct MuLambdaBuffers {
+            std::vector<double> probabilities;
+            std::vector<std::pair<double, size_t>> keys;
+            std::vector<size_t> selected_indexes;
+        };
+
         // Perform the generational (μ, λ) selection. μ out of the λ offsprings are selected using
-        // weighted sampling.
-        template <typename T, class URBG>
-        void generational_mu_lambda_selection(std::vector<PermutationPath<T>>& population_pool,
-                                              std::vector<PermutationPath<T>>&& offspring_pool,
+        // weighted sampling, and stored in the given empty population pool.
+        template <typename T, typename Index, class URBG>
+        void generational_mu_lambda_selection(const PopulationPool<T, Index>& offspring_pool,
+                                              PopulationPool<T, Index>& population_pool,
+                                              size_t mu, MuLambdaBuffers& buffers,
                                               URBG&& random_generator) noexcept {
-            const size_t mu = population_pool.size();
             const size_t lambda = offspring_pool.size();
+            std::vector<double>& probabilities = buffers.probabilities;
 
             /**
              * Compute probabilities of being removed from the offspring pool
              */
 
-            std::vector<double> probabilities;
-            probabilities.reserve(lambda);
+            probabilities.clear();
 
             // c is the normalization factor
-            auto c = T(0);
+            double c = 0.0;
 
-            for (PermutationPath<T>& permutation_path : offspring_pool) {
-                double distance = permutation_path.cost();
+            for (size_t i = 0; i < lambda; ++i) {
+                double distance = offspring_pool.cost(i);
                 probabilities.push_back(distance);
                 c += distance;
             }
@@ -136,22 +181,17 @@ namespace selection {
              * without replacement.
              */
 
-            std::vector<size_t> selected_indexes(sampling::weighted_sample_indexes(
-                probabilities.begin(), probabilities.end(), mu, random_generator));
+            sampling::weighted_sample_indexes(probabilities.cbegin(), probabilities.cend(), mu,
+                                              buffers.selected_indexes, buffers.keys,
+                                              random_generator);
 
             /**
-             * Place the selected offsprings at the beginning of offspring_pool,
-             * reduce the offspring_pool size from λ to μ and move it to population_pool.
+             * Share the rows of the selected offsprings with population_pool.
              */
 
-            std::vector<PermutationPath<T>> sample_result;
-            sample_result.reserve(mu);
-
-            for (size_t i : selected_indexes) {
-                sample_result.emplace_back(offspring_pool[i]);
+            for (size_t i : buffers.selected_indexes) {
+                population_pool.push_back(offspring_pool, i);
             }
-
-            population_pool = std::move(sample_result);
         }
     }  // namespace children
 }  // namespace selection
\ No newline at end of file
@@ -1,21 +1,26 @@
 #pragma once
 
-#include <shared/path_utils/PermutationPath.h>
+#include <shared/path_utils/utils.h>
 
-#include <algorithm>
-#include <vector>
+#include "PopulationPool.h"
 
 namespace statistics {
-    template <typename T>
-    T sum_cost(const std::vector<PermutationPath<T>>& population_pool) noexcept {
-        return std::accumulate(
-            population_pool.cbegin(), population_pool.cend(), T(0.0),
-            [](T cost, const PermutationPath<T>& path) -> T { return cost + path.cost(); });
+    template <typename T, typename Index>
+    utils::cost_t<T> sum_cost(const PopulationPool<T, Index>& population_pool) noexcept {
+        using cost_t = utils::cost_t<T>;
+
+        cost_t sum = 0;
+        for (size_t i = 0; i < population_pool.size(); ++i) {
+            sum += population_pool.cost(i);
+        }
+
+        return sum;
     }
 
-    template <typename T>
-    T average_cost(const std::vector<PermutationPath<T>>& population_pool) noexcept {
-        return sum_cost(population_pool) / static_cast<T>(population_pool.size());
+    template <typename T, typename Index>
+    double average_cost(const PopulationPool<T, Index>& population_pool) noexcept {
+        return static_cast<double>(sum_cost(population_pool)) /
+               static_cast<double>(population_pool.size());
     }
 
 }  // namespace statistics
\ No newline at end of file
@@ -2,68 +2,108 @@
 
 #include <shared/path_utils/utils.h>
 
-#include <algorithm>      // std::generate_n, std::max_element, std::find, std::rotate
+#include <algorithm>      // std::generate_n, std::min, std::max, std::find, std::rotate
+#include <array>          // std::array
 #include <iterator>       // std::next, std::inserter
-#include <limits>         // std::numeric_limits
-#include <list>           // std::list
-#include <type_traits>    // std::forward
-#include <unordered_map>  // std::unordered_map
+#include <type_traits>    // std::forward, std::decay_t
 #include <unordered_set>  // std::unordered_set
 #include <vector>         // std::vector
 
 namespace utils {
-    // Find the arc (i, j) that minimizes the value of w(i, r) - w(r, j) - w(i, j)
-    // and add k in between i and j in circuit.
-    template <typename Distance>
+    // Number of distances computed by each call to the batch distance functions used by the
+    // farthest insertion scans. The scans run on the calling thread: even on d1655, each step of
+    // the construction takes about 10 µs, less than handing the work over to other threads.
+    constexpr size_t DISTANCE_BATCH_SIZE = 256;
+
+    // Find the arc (i, j) of circuit that minimizes the value of w(i, r) + w(r, j) - w(i, j)
+    // and add r in between i and j in circuit.
+    // edge_lengths[i] is the length of the arc that starts from circuit[i], and it's kept aligned
+    // with circuit. Each insertion is scored by its edge delta, so the search is O(n), and the
+    // distances from r are computed in batches by get_distances(r, first, last, out).
+    template <typename T, typename Distance, typename BatchDistance>
     void perform_best_circuit_insertion(const size_t r, std::vector<size_t>& circuit,
-                                        Distance&& get_distance) {
+                                        std::vector<T>& edge_lengths, Distance&& get_distance,
+                                        BatchDistance&& get_distances) {
+        using cost_t = utils::cost_t<T>;
+
         const size_t size = circuit.size();
 
-        // Circuit_combinations will be sequentially modified to represent all possible insertions
-        // of the vertex r between the vertexes in circuit. We prefer this mutable approach rather
-        // than first enumerating all possible insertions and then selecting the best to keep the
-        // space complexity at O(n) instead of O(n^2).
-        // Initially, it is an ordered copy of the given circuit.
-        // We use std::list because insertions and deletions at any point are O(1).
-        std::list<size_t> circuit_insertion_list(circuit.cbegin(), circuit.cend());
-
-        // Compute the first insertion possibility's weight.
-        // For example, suppose that circuit is {3,4,1} and that r = 0.
-        // The possible insertions are {0,3,4,1}, {3,0,4,1}, and {3,4,0,1}.
-        // The following block sets circuit_insertion_list to the first possible insertion
-        // ({0,3,4,1}, according to the example) and saves its circuit weight, i.e.
-        // w(0,3) + w(3,4) + w(4,1) + w(1,0).
-        auto it_list = circuit_insertion_list.begin();
-        it_list = circuit_insertion_list.insert(it_list, r);
-        const auto first_weight = sum_distances_as_circuit(
-            circuit_insertion_list.cbegin(), circuit_insertion_list.cend(), get_distance);
-
-        // keep track of the minimum weight
-        auto min_weight = first_weight;
-
-        // Keep track of the index of the list where the circuit weight is minimized
-        size_t index_min_weight = 0;
-
-        // Compute the other possible insertions removing r from circuit_insertion_list and adding
-        // it again in the next suitable position. Removals and insertions are O(1) because we're
-        // using lists. Since the total possible insertions in a list with n elements is n and we
-        // already computed the first possible insertion, we need only n-2 other iterations.
-        for (size_t i = 1; i < size; ++i) {
-            it_list = circuit_insertion_list.erase(it_list);
-            it_list = circuit_insertion_list.insert(std::next(it_list), r);
-            const auto weight = sum_distances_as_circuit(
-                circuit_insertion_list.cbegin(), circuit_insertion_list.cend(), get_distance);
-
-            if (weight < min_weight) {
-                min_weight = weight;
-                index_min_weight = i;
+        // position that follows i in the circuit
+        const auto next = [size](const size_t i) { return i + 1 == size ? 0 : i + 1; };
+
+        // cost increase caused by inserting r right after circuit[i]
+        const auto insertion_delta = [&](const size_t i) -> cost_t {
+            return cost_t(get_distance(circuit[i], r)) + cost_t(get_distance(r, circuit[next(i)])) -
+                   cost_t(edge_lengths[i]);
+        };
+
+        size_t best = 0;
+        cost_t min_delta = insertion_delta(0);
+
+        // distances from r to the nodes of the current batch, followed by the next node
+        std::array<T, DISTANCE_BATCH_SIZE + 1> batch;
+
+        for (size_t batch_first = 0; batch_first < size; batch_first += DISTANCE_BATCH_SIZE) {
+            const size_t batch_last = std::min(batch_first + DISTANCE_BATCH_SIZE, size);
+            const size_t batch_size = batch_last - batch_first;
+
+            get_distances(r, circuit.data() + batch_first, circuit.data() + batch_last,
+                          batch.data());
+            batch[batch_size] = get_distance(r, circuit[next(batch_last - 1)]);
+
+            for (size_t k = 0; k < batch_size; ++k) {
+                const size_t i = batch_first + k;
+                const cost_t delta =
+                    cost_t(batch[k]) + cost_t(batch[k + 1]) - cost_t(edge_lengths[i]);
+
+                if (delta < min_delta) {
+                    min_delta = delta;
+                    best = i;
+                }
+            }
+        }
+
+        // Add r right after circuit[best], replacing the arc (circuit[best], circuit[best + 1])
+        // with two arcs. These operations take O(n), because circuit is a vector.
+        const T length_after_r = get_distance(r, circuit[next(best)]);
+        edge_lengths[best] = get_distance(circuit[best], r);
+        edge_lengths.insert(std::next(edge_lengths.begin(), best + 1), length_after_r);
+        circuit.insert(std::next(circuit.begin(), best + 1), r);
+    }
+
+    // Lower the minimum distance δ(k, circuit) of every candidate vertex k not in the partial
+    // Hamiltonian circuit, after the vertex r has been added to the circuit. min_distances[i] is
+    // the minimum distance of candidates[i]. Return the index in candidates of the vertex that
+    // maximizes δ(k, circuit).
+    // get_distances(r, first, last, out) stores in out the distances between r and the vertexes in
+    // [first, last), so that they can be computed in batches.
+    template <typename T, typename BatchDistance>
+    [[nodiscard]] size_t update_min_distances_select_farthest(const std::vector<size_t>& candidates,
+                                                              std::vector<T>& min_distances,
+                                                              const size_t r,
+                                                              BatchDistance&& get_distances) {
+        const size_t size = candidates.size();
+        size_t best = 0;
+        std::array<T, DISTANCE_BATCH_SIZE> batch;
+
+        for (size_t batch_first = 0; batch_first < size; batch_first += DISTANCE_BATCH_SIZE) {
+            const size_t batch_last = std::min(batch_first + DISTANCE_BATCH_SIZE, size);
+            get_distances(r, candidates.data() + batch_first, candidates.data() + batch_last,
+                          batch.data());
+
+            for (size_t i = batch_first; i < batch_last; ++i) {
+                const T distance = batch[i - batch_first];
+                if (distance < min_distances[i]) {
+                    min_distances[i] = distance;
+                }
+
+                if (min_distances[i] > min_distances[best]) {
+                    best = i;
+                }
             }
         }
 
-        // Add r to the place where the circuit weight is minimized.
-        // This operation takes O(n), because circuit is a vector.
-        const auto it_insert = std::next(circuit.begin(), index_min_weight);
-        circuit.insert(it_insert, r);
+        return best;
     }
 
     // Generate an unordered set with integer values in range [low, high)
@@ -86,63 +126,6 @@ namespace utils {
         return std::move(node.value());
     }
 
-    // Return the maximum element in a list of elements.
-    // This std::max_element wrapper is necessary to force the compiler to choose the right overload
-    // of a higher-order function at compile-time.
-    // See: https://stackoverflow.com/a/36794145/6174476
-    const auto max_element = [](auto&&... args) -> decltype(auto) {
-        return std::max_element(std::forward<decltype(args)>(args)...);
-    };
-
-    // Return the vertex r that doesn't belong to the partial Hamiltonian circuit that
-    // maximizes the distance δ(r, circuit).
-    // get_distance is the distance function that computes the cost between 2 nodes.
-    template <typename Distance>
-    [[nodiscard]] size_t select_new_r_maximize(std::unordered_set<size_t>& not_visited,
-                                               std::vector<size_t>& circuit,
-                                               Distance&& get_distance) noexcept {
-        return select_new_r(not_visited, circuit, get_distance, max_element);
-    }
-
-    // Return the vertex r that doesn't belong to the partial Hamiltonian circuit that
-    // maximizes or minimizes the distance δ(r, circuit) w.r.t. get_best_r.
-    // get_distance is the distance function that computes the cost between 2 nodes.
-    template <class GetBestR, typename Distance>
-    [[nodiscard]] size_t select_new_r(std::unordered_set<size_t>& not_visited,
-                                      std::vector<size_t>& circuit, Distance&& get_distance,
-                                      GetBestR&& get_best_r) noexcept {
-        using distance_t = decltype(get_distance(0, 0));
-
-        // map that stores the minimum distance for each candidate vertex k
-        std::unordered_map<size_t, distance_t> node_min_weight_map;
-        node_min_weight_map.reserve(not_visited.size());
-
-        for (const auto r : not_visited) {
-            distance_t min_hk_weight = std::numeric_limits<distance_t>::max();
-            for (const auto h : circuit) {
-                const distance_t weight = get_distance(h, r);
-
-                if (weight < min_hk_weight) {
-                    min_hk_weight = weight;
-                }
-            }
-
-            // update the map with the minimum weight between h and r found up to now
-            node_min_weight_map[r] = min_hk_weight;
-        }
-
-        // both std::min_element and std::max_element need a comparator that returns true when x < y
-        auto map_comparator = [](const auto& x, const auto& y) { return x.second < y.second; };
-
-        // maximize or minimize distances based on comparator
-        const auto it_new_r = get_best_r(node_min_weight_map.cbegin(), node_min_weight_map.cend(),
-                                         std::move(map_comparator));
-
-        // obtain the maximum of the maximum or minimum distances δ(r, circuit)
-        const size_t new_r = it_new_r->first;
-        return new_r;
-    }
-
     // Shift a range in a container such that the given value is placed in the first position. No
     // items are removed in the process.
     template <typename T, class ForwardIt>
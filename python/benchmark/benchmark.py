@@ -118,6 +118,7 @@ def parse_ex2_metaheuristic_output(stdout: Iterable):
     ('N', int),
     ('program_time_ms', int),
     ('was_interrupted', lambda x: True if int(x) > 0 else False),
+    ('steady_state_allocations', int),
     ('solution', compose(int)(float)),
   ]
 
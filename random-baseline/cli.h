@@ -13,6 +13,13 @@ namespace cli {
 
         bool& show_path = flag("s,show-path", "Show the path of the solution").set_default(false);
 
+        bool& hilbert =
+            flag("hilbert", "Renumber the cities along a Hilbert curve").set_default(false);
+
+        std::string& distance_type =
+            kwarg("d,distance-type", "Type of the distances: double, int32, uint16")
+                .set_default("double");
+
         // Show introductory message to the users
         void welcome() override {
             std::cout << "Random baseline solver\n";
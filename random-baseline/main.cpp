@@ -3,28 +3,25 @@
 #include <optional>  // std::optional
 
 #include <shared/DistanceMatrix.h>
+#include <shared/DistanceType.h>
 #include <shared/read_tsp_file.h>
 #include <shared/stopwatch.h>
 
 #include "cli.h"
 #include "RandomSolver.h"
 
-int main(int argc, char** argv) {
-    /**
-     * Handler for command-line arguments
-     */
-    auto args = cli::parse(argc, argv);
+// Solve the TSP instance read by point_reader, using distances of type T
+template <typename T>
+void run(const cli::CLIArgs& args, point_reader::PointReader& point_reader) {
     std::chrono::duration timeout_ms = std::chrono::milliseconds(args.timeout_ms);
 
-    auto point_reader(read_tsp_file(args.filename.c_str()));
-
-    const size_t N = point_reader->dimension;
-    DistanceMatrix<double> distance_matrix = point_reader->create_distance_matrix();
+    const size_t N = point_reader.dimension;
+    DistanceMatrix<T> distance_matrix = point_reader.create_distance_matrix<T>();
 
     // start the stopwatch
     const auto program_time_start = stopwatch::now();
 
-    RandomSolver<double> random_solver(distance_matrix, timeout_ms);
+    RandomSolver<T> random_solver(distance_matrix, timeout_ms);
 
     random_solver.solve();
 
@@ -39,13 +36,34 @@ int main(int argc, char** argv) {
     std::cout << "program_time_ms: " << program_time_ms << '\n';
     std::cout << "was_interrupted: " << true << '\n';
 
-    PermutationPath<double> solution_path(random_solver.get_solution());
+    PermutationPath<T> solution_path(random_solver.get_solution());
 
     std::cout << "solution_cost: " << std::fixed << solution_path.cost();
 
     if (args.show_path) {
-        std::cout << "Solution path:\n" << solution_path << '\n';
+        // the cities are printed with the labels of the input file
+        std::cout << "Solution path:\n";
+        solution_path.print(std::cout,
+                            [&](size_t city) { return point_reader.original_label(city); });
+        std::cout << '\n';
     }
 
     std::cout << std::flush;
 }
+
+int main(int argc, char** argv) {
+    /**
+     * Handler for command-line arguments
+     */
+    auto args = cli::parse(argc, argv);
+
+    auto point_reader(read_tsp_file(args.filename.c_str()));
+
+    if (args.hilbert) {
+        point_reader->renumber_along_hilbert_curve();
+    }
+
+    // instantiate the solver with the distance type chosen by the user
+    visit_distance_type(parse_distance_type(args.distance_type),
+                        [&](auto distance) { run<decltype(distance)>(args, *point_reader); });
+}
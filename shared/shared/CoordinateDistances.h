@@ -0,0 +1,361 @@
+#pragma once
+
+#include <algorithm>    // std::sort, std::minmax_element, std::minmax
+#include <cstdint>      // int32_t
+#include <limits>       // std::numeric_limits
+#include <numeric>      // std::iota
+#include <stdexcept>    // std::overflow_error, std::runtime_error
+#include <type_traits>  // std::is_integral_v, std::is_same_v
+#include <utility>      // std::pair, std::move
+#include <vector>       // std::vector
+
+#include "read_tsp_utils/EdgeWeightType.h"
+#include "read_tsp_utils/metrics.h"
+
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>  // SSE2 intrinsics
+#define COORDINATE_DISTANCES_SSE2
+#endif
+
+// AVX kernels are compiled regardless of -march with the target attribute, and are only used if
+// the CPU supports them at runtime
+#if defined(COORDINATE_DISTANCES_SSE2) && (defined(__GNUC__) || defined(__clang__))
+#include <immintrin.h>  // AVX intrinsics
+#define COORDINATE_DISTANCES_AVX
+#define COORDINATE_DISTANCES_AVX_TARGET __attribute__((target("avx")))
+#endif
+
+/**
+ * CoordinateDistances computes the distances of a set of 2D points on demand, rather than
+ * storing them in an n×n matrix. It only needs O(n) memory, so it can handle instances that are
+ * too large for a DistanceMatrix.
+ * The coordinates are stored in a structure of arrays (x[] and y[]), so that the batch methods
+ * can compute multiple distances with SIMD instructions.
+ * The metric is any TSPLIB metric defined on coordinates. Its distance functor is selected once
+ * per call with distance::visit_metric, so that the batch loops are fully inlined.
+ */
+template <typename T = double>
+class CoordinateDistances {
+    std::vector<double> x;
+    std::vector<double> y;
+    EdgeWeightType metric;
+
+    // True if the SIMD kernels can be used: they only compute EUC_2D distances, which must fit
+    // in a 32-bit integer
+    bool is_simd_safe = false;
+
+    // True if the SIMD kernels can use AVX instructions
+    bool is_avx_enabled = false;
+
+    static constexpr double ROUNDING_OFFSET = distance::detail::ROUNDING_OFFSET;
+
+    // Return an upper bound of the distance between any two points, computed from their bounding
+    // box
+    [[nodiscard]] double max_distance_bound() const noexcept {
+        if (x.empty()) {
+            return 0.0;
+        }
+
+        const auto [x_min, x_max] = std::minmax_element(x.cbegin(), x.cend());
+        const auto [y_min, y_max] = std::minmax_element(y.cbegin(), y.cend());
+        const double width = *x_max - *x_min;
+        const double height = *y_max - *y_min;
+
+        return distance::visit_metric(metric, [width, height](auto metric_distance) {
+            return distance::max_distance(metric_distance, width, height);
+        });
+    }
+
+    // Return the indexes of the vertexes of the convex hull of the points, computed with Andrew's
+    // monotone chain algorithm in O(n log n)
+    [[nodiscard]] std::vector<size_t> convex_hull() const {
+        std::vector<size_t> points(size());
+        std::iota(points.begin(), points.end(), 0);
+
+        if (points.size() < 3) {
+            return points;
+        }
+
+        std::sort(points.begin(), points.end(), [this](size_t a, size_t b) {
+            return x[a] < x[b] || (x[a] == x[b] && y[a] < y[b]);
+        });
+
+        // cross product of the vectors (o, a) and (o, b)
+        const auto cross = [this](size_t o, size_t a, size_t b) {
+            return (x[a] - x[o]) * (y[b] - y[o]) - (y[a] - y[o]) * (x[b] - x[o]);
+        };
+
+        std::vector<size_t> hull(2 * points.size());
+        size_t k = 0;
+
+        // lower hull
+        for (size_t i = 0; i < points.size(); ++i) {
+            while (k >= 2 && cross(hull[k - 2], hull[k - 1], points[i]) <= 0) {
+                --k;
+            }
+            hull[k++] = points[i];
+        }
+
+        // upper hull
+        for (size_t i = points.size() - 1, lower_size = k + 1; i > 0; --i) {
+            while (k >= lower_size && cross(hull[k - 2], hull[k - 1], points[i - 1]) <= 0) {
+                --k;
+            }
+            hull[k++] = points[i - 1];
+        }
+
+        // the last point is equal to the first one
+        hull.resize(k > 1 ? k - 1 : k);
+        return hull;
+    }
+
+    // Return the indexes of the points that can be one of the two farthest points. With a
+    // Euclidean-like metric, they're the vertexes of the convex hull. With MAN_2D, they're the
+    // extremes of x + y and x - y. With GEO, every point is a candidate.
+    template <class Metric>
+    [[nodiscard]] std::vector<size_t> farthest_candidates() const {
+        if constexpr (distance::is_euclidean_monotone<Metric>()) {
+            return convex_hull();
+        } else if constexpr (std::is_same_v<Metric, distance::Manhattan2D>) {
+            std::vector<size_t> points(size());
+            std::iota(points.begin(), points.end(), 0);
+
+            if (points.empty()) {
+                return points;
+            }
+
+            const auto [sum_min, sum_max] = std::minmax_element(
+                points.cbegin(), points.cend(),
+                [this](size_t a, size_t b) { return x[a] + y[a] < x[b] + y[b]; });
+            const auto [difference_min, difference_max] = std::minmax_element(
+                points.cbegin(), points.cend(),
+                [this](size_t a, size_t b) { return x[a] - y[a] < x[b] - y[b]; });
+
+            return {*sum_min, *sum_max, *difference_min, *difference_max};
+        } else {
+            std::vector<size_t> points(size());
+            std::iota(points.begin(), points.end(), 0);
+            return points;
+        }
+    }
+
+    // Return the two farthest points, comparing the distances of the candidates
+    template <class Metric>
+    [[nodiscard]] std::pair<size_t, size_t> farthest_pair(Metric metric_distance) const {
+        const std::vector<size_t> candidates(farthest_candidates<Metric>());
+        const auto pair_distance = [this, metric_distance](size_t a, size_t b) {
+            return metric_distance(x[a], y[a], x[b], y[b]);
+        };
+
+        std::pair<size_t, size_t> farthest{0, size() > 1 ? 1 : 0};
+        double max_distance = pair_distance(farthest.first, farthest.second);
+
+        for (size_t a = 0; a < candidates.size(); ++a) {
+            for (size_t b = a + 1; b < candidates.size(); ++b) {
+                const double candidate_distance = pair_distance(candidates[a], candidates[b]);
+
+                if (candidate_distance > max_distance) {
+                    max_distance = candidate_distance;
+                    farthest = std::minmax(candidates[a], candidates[b]);
+                }
+            }
+        }
+
+        return farthest;
+    }
+
+#ifdef COORDINATE_DISTANCES_SSE2
+    // Compute the rounded distances between (x_i, y_i) and the 2 points packed in x_j and y_j
+    [[nodiscard]] static __m128d distance_kernel(__m128d x_i, __m128d y_i, __m128d x_j,
+                                                 __m128d y_j) noexcept {
+        const __m128d dx = _mm_sub_pd(x_i, x_j);
+        const __m128d dy = _mm_sub_pd(y_i, y_j);
+        const __m128d distance = _mm_sqrt_pd(_mm_add_pd(_mm_mul_pd(dx, dx), _mm_mul_pd(dy, dy)));
+        const __m128d offset = _mm_set1_pd(ROUNDING_OFFSET);
+        return _mm_cvtepi32_pd(_mm_cvttpd_epi32(_mm_add_pd(distance, offset)));
+    }
+
+    // Store the 2 distances packed in distance to out[0] and out[1]
+    static void store_distances(__m128d distance, T* out) noexcept {
+        if constexpr (std::is_same_v<T, double>) {
+            _mm_storeu_pd(out, distance);
+        } else {
+            alignas(16) double buffer[2];
+            _mm_store_pd(buffer, distance);
+            out[0] = static_cast<T>(buffer[0]);
+            out[1] = static_cast<T>(buffer[1]);
+        }
+    }
+#endif
+
+#ifdef COORDINATE_DISTANCES_AVX
+    // Compute the distances between the i-th point and the points in [first, last), 4 at a time,
+    // and store them in out. Return the number of distances that have been computed.
+    COORDINATE_DISTANCES_AVX_TARGET size_t row_avx(size_t i, size_t first, size_t last,
+                                                   T* out) const noexcept {
+        const __m256d x_i = _mm256_set1_pd(x[i]);
+        const __m256d y_i = _mm256_set1_pd(y[i]);
+        const __m256d offset = _mm256_set1_pd(ROUNDING_OFFSET);
+        size_t k = 0;
+
+        for (; first + k + 4 <= last; k += 4) {
+            const __m256d dx = _mm256_sub_pd(x_i, _mm256_loadu_pd(x.data() + first + k));
+            const __m256d dy = _mm256_sub_pd(y_i, _mm256_loadu_pd(y.data() + first + k));
+            const __m256d distance =
+                _mm256_sqrt_pd(_mm256_add_pd(_mm256_mul_pd(dx, dx), _mm256_mul_pd(dy, dy)));
+            const __m128i rounded = _mm256_cvttpd_epi32(_mm256_add_pd(distance, offset));
+
+            if constexpr (std::is_same_v<T, double>) {
+                _mm256_storeu_pd(out + k, _mm256_cvtepi32_pd(rounded));
+            } else if constexpr (std::is_same_v<T, int32_t>) {
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(out + k), rounded);
+            } else {
+                alignas(16) int32_t buffer[4];
+                _mm_store_si128(reinterpret_cast<__m128i*>(buffer), rounded);
+                for (size_t b = 0; b < 4; ++b) {
+                    out[k + b] = static_cast<T>(buffer[b]);
+                }
+            }
+        }
+
+        _mm256_zeroupper();
+        return k;
+    }
+
+    [[nodiscard]] static bool is_avx_supported() noexcept {
+        return __builtin_cpu_supports("avx");
+    }
+#endif
+
+public:
+    // Create the distance oracle of the points (x[i], y[i]) with the given metric, which can't
+    // be EXPLICIT. x and y must have the same size.
+    // If T is integral and a distance doesn't fit in it, std::overflow_error is thrown.
+    CoordinateDistances(std::vector<double> x, std::vector<double> y,
+                        EdgeWeightType metric = EdgeWeightType::EUC_2D) :
+        x(std::move(x)), y(std::move(y)), metric(metric) {
+        if (metric == EdgeWeightType::EXPLICIT) {
+            throw std::runtime_error("EXPLICIT distances can't be computed from coordinates");
+        }
+
+        const double max_distance = max_distance_bound();
+
+        if constexpr (std::is_integral_v<T>) {
+            // the bounding box is only an upper bound, the exact check is done on the two
+            // farthest points
+            const double max_value = static_cast<double>(std::numeric_limits<T>::max());
+            if (max_distance > max_value) {
+                const auto [a, b] = get_2_farthest_vertexes();
+                if (distance(a, b) > max_value) {
+                    throw std::overflow_error(
+                        "The distances don't fit in the chosen distance type");
+                }
+            }
+        }
+
+        const double max_int32 = static_cast<double>(std::numeric_limits<int32_t>::max());
+        this->is_simd_safe = metric == EdgeWeightType::EUC_2D && max_distance < max_int32;
+
+#ifdef COORDINATE_DISTANCES_AVX
+        this->is_avx_enabled = this->is_simd_safe && is_avx_supported();
+#endif
+    }
+
+    // Return the number of points
+    [[nodiscard]] size_t size() const noexcept {
+        return x.size();
+    }
+
+    // Return the metric of the distances
+    [[nodiscard]] EdgeWeightType get_metric() const noexcept {
+        return metric;
+    }
+
+    // Compute the distance between the i-th and the j-th point, without narrowing it to T
+    [[nodiscard]] double distance(size_t i, size_t j) const noexcept {
+        return distance::visit_metric(metric, [this, i, j](auto metric_distance) {
+            return metric_distance(x[i], y[i], x[j], y[j]);
+        });
+    }
+
+    // Compute the distance between the i-th and the j-th point
+    [[nodiscard]] T at(size_t i, size_t j) const noexcept {
+        return static_cast<T>(distance(i, j));
+    }
+
+    // Compute the distance between the i-th point and each point in [first, last), and store
+    // them in out, which must have room for last - first values
+    void distances(size_t i, const size_t* first, const size_t* last, T* out) const noexcept {
+        const size_t count = last - first;
+        size_t k = 0;
+
+#ifdef COORDINATE_DISTANCES_SSE2
+        if (this->is_simd_safe) {
+            const __m128d x_i = _mm_set1_pd(x[i]);
+            const __m128d y_i = _mm_set1_pd(y[i]);
+
+            for (; k + 2 <= count; k += 2) {
+                const size_t j_0 = first[k];
+                const size_t j_1 = first[k + 1];
+                const __m128d x_j = _mm_set_pd(x[j_1], x[j_0]);
+                const __m128d y_j = _mm_set_pd(y[j_1], y[j_0]);
+                store_distances(distance_kernel(x_i, y_i, x_j, y_j), out + k);
+            }
+        }
+#endif
+
+        distance::visit_metric(metric, [&](auto metric_distance) {
+            for (; k < count; ++k) {
+                const size_t j = first[k];
+                out[k] = static_cast<T>(metric_distance(x[i], y[i], x[j], y[j]));
+            }
+        });
+    }
+
+    // Compute the distance between the i-th point and every point in [first, last), and store
+    // them in out, which must have room for last - first values
+    void row(size_t i, size_t first, size_t last, T* out) const noexcept {
+        // out[k] is the distance between the i-th and the (first + k)-th point
+        const size_t count = last - first;
+        size_t k = 0;
+
+#ifdef COORDINATE_DISTANCES_AVX
+        if (this->is_avx_enabled) {
+            k = row_avx(i, first, last, out);
+        }
+#endif
+
+#ifdef COORDINATE_DISTANCES_SSE2
+        if (this->is_simd_safe) {
+            const __m128d x_i = _mm_set1_pd(x[i]);
+            const __m128d y_i = _mm_set1_pd(y[i]);
+
+            for (; k + 2 <= count; k += 2) {
+                const __m128d x_j = _mm_loadu_pd(x.data() + first + k);
+                const __m128d y_j = _mm_loadu_pd(y.data() + first + k);
+                store_distances(distance_kernel(x_i, y_i, x_j, y_j), out + k);
+            }
+        }
+#endif
+
+        distance::visit_metric(metric, [&](auto metric_distance) {
+            for (; k < count; ++k) {
+                const size_t j = first + k;
+                out[k] = static_cast<T>(metric_distance(x[i], y[i], x[j], y[j]));
+            }
+        });
+    }
+
+    // Compute the distance between the i-th point and every point, and store them in out, which
+    // must have room for size() values
+    void row(size_t i, T* out) const noexcept {
+        row(i, 0, size(), out);
+    }
+
+    // Return the two farthest points. Only the pairs of candidates of the metric are compared,
+    // e.g. the vertexes of the convex hull for EUC_2D.
+    [[nodiscard]] std::pair<size_t, size_t> get_2_farthest_vertexes() const {
+        return distance::visit_metric(
+            metric, [this](auto metric_distance) { return farthest_pair(metric_distance); });
+    }
+};
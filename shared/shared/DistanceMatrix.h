@@ -1,22 +1,67 @@
 #pragma once
 
-#include <algorithm>  // std::max_element
+#include <algorithm>  // std::max_element, std::min, std::max
 #include <cmath>      // std::sqrt
 #include <iomanip>    // std::setw
 #include <iostream>   // std::ostream
+#include <memory>     // std::shared_ptr
 #include <numeric>    // std::iota
+#include <thread>     // std::thread
+#include <utility>    // std::move
 #include <vector>     // std::vector
 
+#include "CoordinateDistances.h"
 #include "Matrix.h"
 
+// Storage layouts supported by DistanceMatrix.
+// FULL stores every n×n value, PACKED only stores the upper triangle (main diagonal included),
+// halving the memory footprint.
+enum class DistanceMatrixLayout { FULL, PACKED };
+
 /**
  * DistanceMatrix represents a distance matrix for a complete, weighted, undirected graph.
  * It's a symmetric matrix which main diagonal is filled with 0s.
- * It stores its values in a contiguous 1D vector.
+ * It stores its values in a contiguous 1D vector, according to the chosen DistanceMatrixLayout.
+ * In the full layout, at(i, j) reads the value at i * n + j. In the packed layout, it reads the
+ * value at row min(i, j), column max(i, j) through a table of row offsets. The layout is fixed
+ * per matrix, so the branch on it is always predicted.
+ * The values can also live outside of the matrix, e.g. in the memory-mapped pages of a binary
+ * instance file, in which case they're read-only and never copied.
  */
 template <typename T = double>
 class DistanceMatrix : public Matrix<T> {
     size_t n_vertexes;
+    DistanceMatrixLayout layout;
+
+    // row_offset[i] + j is the position of (i, j) in the vector data, for every i <= j.
+    // It's only read on the hot path in the packed layout.
+    std::vector<size_t> row_offset;
+
+    // keeps the external values alive, if the matrix doesn't own them
+    std::shared_ptr<const void> storage;
+
+    // values of the matrix, either this->data.data() or external values
+    const T* values;
+
+    // Return the number of values stored for a matrix with n_vertexes rows in the given layout
+    [[nodiscard]] static size_t storage_size(size_t n_vertexes,
+                                             DistanceMatrixLayout layout) noexcept {
+        return layout == DistanceMatrixLayout::PACKED ? n_vertexes * (n_vertexes + 1) / 2
+                                                      : n_vertexes * n_vertexes;
+    }
+
+    // Compute the position of the first value of each row in the vector data.
+    // In the packed layout, the i-th row starts with the i-th column, so it's shorter than the
+    // previous one by 1 value.
+    void init_row_offset() {
+        row_offset.resize(n_vertexes);
+
+        for (size_t i = 0; i < n_vertexes; ++i) {
+            row_offset[i] = layout == DistanceMatrixLayout::PACKED
+                                ? i * n_vertexes - i * (i + 1) / 2
+                                : i * n_vertexes;
+        }
+    }
 
     // Initialize the distance matrix according to the distance(i, j) function.
     // The vector data is already filled with 0s.
@@ -27,38 +72,208 @@ class DistanceMatrix : public Matrix<T> {
         // Populate the triangle above the main diagonal
         for (size_t i = 0; i < dimension; ++i) {
             for (size_t j = i + 1; j < dimension; ++j) {
-                this->at(i, j) = distance(i, j);
+                this->data[row_offset[i] + j] = distance(i, j);
             }
         }
 
+        if (layout == DistanceMatrixLayout::PACKED) {
+            return;
+        }
+
         // Symmetrically copies the triangle above the main diagonal to the triangle
         // below the main diagonal
         for (size_t i = dimension - 1; i > 0; --i) {
             for (size_t j = 0; j < i; ++j) {
-                this->at(i, j) = this->at(j, i);
+                this->data[i * dimension + j] = this->at(j, i);
+            }
+        }
+    }
+
+    // Side of the square tiles in which the matrix is computed from coordinates. A tile of doubles
+    // takes 32KB, so it stays in cache while it's mirrored below the main diagonal.
+    static constexpr size_t TILE_SIZE = 64;
+
+    // Minimum number of rows that justifies spawning a new thread
+    static constexpr size_t MIN_ROWS_PER_THREAD = 256;
+
+    // Compute the tiles of the block row that starts at the row TILE_SIZE * block_row.
+    // Each row of a tile above the main diagonal is computed at once by the SIMD kernels of
+    // coordinates and written contiguously. In the full layout, the tile is then mirrored to the
+    // triangle below the main diagonal. Different block rows write disjoint values.
+    void init_block_row(const CoordinateDistances<T>& coordinates, size_t block_row) noexcept {
+        const size_t dimension = size();
+        const size_t i_first = block_row * TILE_SIZE;
+        const size_t i_last = std::min(i_first + TILE_SIZE, dimension);
+        const bool is_full = layout == DistanceMatrixLayout::FULL;
+
+        for (size_t j_first = i_first; j_first < dimension; j_first += TILE_SIZE) {
+            const size_t j_last = std::min(j_first + TILE_SIZE, dimension);
+
+            for (size_t i = i_first; i < i_last; ++i) {
+                const size_t j_begin = std::max(j_first, i + 1);
+
+                if (j_begin < j_last) {
+                    coordinates.row(i, j_begin, j_last, &this->data[row_offset[i] + j_begin]);
+                }
+            }
+
+            if (is_full) {
+                for (size_t j = j_first; j < j_last; ++j) {
+                    for (size_t i = i_first; i < std::min(i_last, j); ++i) {
+                        this->data[j * dimension + i] = this->data[i * dimension + j];
+                    }
+                }
             }
         }
     }
 
+    // Initialize the distance matrix from the coordinates of the points, splitting the block rows
+    // among the available threads. The vector data is already filled with 0s.
+    void init(const CoordinateDistances<T>& coordinates) {
+        const size_t dimension = size();
+        const size_t n_block_rows = (dimension + TILE_SIZE - 1) / TILE_SIZE;
+        const size_t n_threads = std::max<size_t>(
+            1, std::min<size_t>(std::thread::hardware_concurrency(),
+                                dimension / MIN_ROWS_PER_THREAD));
+
+        // the block rows get shorter and shorter, so they're assigned in a round-robin fashion
+        const auto init_block_rows = [&](size_t thread) {
+            for (size_t block_row = thread; block_row < n_block_rows; block_row += n_threads) {
+                init_block_row(coordinates, block_row);
+            }
+        };
+
+        std::vector<std::thread> threads;
+        threads.reserve(n_threads - 1);
+
+        for (size_t thread = 1; thread < n_threads; ++thread) {
+            threads.emplace_back(init_block_rows, thread);
+        }
+
+        init_block_rows(0);
+
+        for (auto& thread : threads) {
+            thread.join();
+        }
+    }
+
 public:
+    // Create the distance matrix of the points of coordinates, computing it in parallel with the
+    // SIMD kernels of CoordinateDistances
+    DistanceMatrix(const CoordinateDistances<T>& coordinates,
+                   DistanceMatrixLayout layout = DistanceMatrixLayout::FULL) :
+        Matrix<T>(coordinates.size(), coordinates.size(),
+                  std::vector<T>(storage_size(coordinates.size(), layout), T(0))),
+        n_vertexes(coordinates.size()),
+        layout(layout),
+        values(this->data.data()) {
+        init_row_offset();
+        init(coordinates);
+    }
+
     // Create a new square matrix with n_vertexes rows initialized to all 0s.
     // distance(i, j) returns the distance between the i-th and j-th point.
     template <typename Distance>
-    DistanceMatrix(size_t n_vertexes, Distance&& distance) noexcept :
-        Matrix<T>(n_vertexes, n_vertexes, T(0)), n_vertexes(n_vertexes) {
+    DistanceMatrix(size_t n_vertexes, Distance&& distance,
+                   DistanceMatrixLayout layout = DistanceMatrixLayout::FULL) noexcept :
+        Matrix<T>(n_vertexes, n_vertexes, std::vector<T>(storage_size(n_vertexes, layout), T(0))),
+        n_vertexes(n_vertexes),
+        layout(layout),
+        values(this->data.data()) {
+        init_row_offset();
         init(std::forward<Distance>(distance));
     }
 
+    // Wrap the values of a matrix with n_vertexes rows stored elsewhere according to layout,
+    // without copying them. storage keeps the values alive as long as the matrix needs them.
+    DistanceMatrix(size_t n_vertexes, DistanceMatrixLayout layout, const T* values,
+                   std::shared_ptr<const void> storage) :
+        Matrix<T>(n_vertexes, n_vertexes, std::vector<T>()),
+        n_vertexes(n_vertexes),
+        layout(layout),
+        storage(std::move(storage)),
+        values(values) {
+        init_row_offset();
+    }
+
     // Constructor left for test purposes
     DistanceMatrix(const std::vector<T>& vec, size_t n_vertexes) noexcept :
-        Matrix<T>(n_vertexes, n_vertexes, vec), n_vertexes(n_vertexes) {
+        Matrix<T>(n_vertexes, n_vertexes, vec),
+        n_vertexes(n_vertexes),
+        layout(DistanceMatrixLayout::FULL),
+        values(this->data.data()) {
+        init_row_offset();
+    }
+
+    // values must point to the data of the copy, unless they're external
+    DistanceMatrix(const DistanceMatrix& other) :
+        Matrix<T>(other),
+        n_vertexes(other.n_vertexes),
+        layout(other.layout),
+        row_offset(other.row_offset),
+        storage(other.storage),
+        values(storage != nullptr ? other.values : this->data.data()) {
+    }
+
+    DistanceMatrix(DistanceMatrix&& other) noexcept :
+        Matrix<T>(std::move(other)),
+        n_vertexes(other.n_vertexes),
+        layout(other.layout),
+        row_offset(std::move(other.row_offset)),
+        storage(std::move(other.storage)),
+        values(storage != nullptr ? other.values : this->data.data()) {
     }
 
+    // the dimensions of Matrix are const, and values would have to be re-pointed anyway
+    DistanceMatrix& operator=(const DistanceMatrix&) = delete;
+    DistanceMatrix& operator=(DistanceMatrix&&) = delete;
+
     // Return number of rows/columns of the matrix
     [[nodiscard]] size_t size() const noexcept {
         return this->rows;
     }
 
+    // Return the storage layout of the matrix
+    [[nodiscard]] DistanceMatrixLayout get_layout() const noexcept {
+        return layout;
+    }
+
+    // Return the values of the matrix, in the order defined by its layout
+    [[nodiscard]] const T* raw_data() const noexcept {
+        return values;
+    }
+
+    // Return the number of values returned by raw_data()
+    [[nodiscard]] size_t raw_size() const noexcept {
+        return storage_size(n_vertexes, layout);
+    }
+
+    // Retrieve the value saved at position (i, j). The values are read-only, since they may be
+    // external: there's no non-const overload, which also hides the one of Matrix.
+    [[nodiscard]] const T& at(size_t i, size_t j) const noexcept {
+        if (layout == DistanceMatrixLayout::FULL) {
+            return values[i * n_vertexes + j];
+        }
+
+        return values[row_offset[std::min(i, j)] + std::max(i, j)];
+    }
+
+    // Initial iterator for the upper triangle of the matrix
+    auto upper_triangular_cbegin() const {
+        const auto N = this->rows;
+        const bool packed = layout == DistanceMatrixLayout::PACKED;
+        return typename Matrix<T>::template upper_triangular_iterator<T>(
+            const_cast<T*>(values), N, 0, 1, packed);
+    }
+
+    // Final iterator for the upper triangle of the matrix
+    auto upper_triangular_cend() const {
+        const auto N = this->rows;
+        const bool packed = layout == DistanceMatrixLayout::PACKED;
+        return typename Matrix<T>::template upper_triangular_iterator<T>(
+            const_cast<T*>(values), N, N - 1, N, packed);
+    }
+
     // Return the vertexes in the distance matrix
     [[nodiscard]] std::vector<size_t> get_vertexes() const noexcept {
         std::vector<size_t> v(n_vertexes);
@@ -73,4 +288,19 @@ public:
         const auto it_max = std::max_element(it_begin, it_end);
         return it_max.get_row_column();
     }
+
+    // Pretty-print distance matrix, useful for debugging/visualization purposes
+    friend std::ostream& operator<<(std::ostream& os, const DistanceMatrix<T>& matrix) {
+        const auto width = 8;
+        const size_t size = matrix.size();
+
+        for (size_t row = 0; row < size; ++row) {
+            for (size_t column = 0; column < size - 1; ++column) {
+                os << std::setw(width) << matrix.at(row, column) << ' ';
+            }
+            os << std::setw(width) << matrix.at(row, size - 1) << std::endl;
+        }
+
+        return os;
+    }
 };
@@ -0,0 +1,52 @@
+#pragma once
+
+#include <cstdint>      // int32_t, uint16_t
+#include <stdexcept>    // std::runtime_error
+#include <string>       // std::string, std::string_literals
+#include <type_traits>  // std::is_same_v
+
+// Numeric types that the distance matrix, the paths and the solvers can be instantiated with.
+// Since TSPLIB Euclidean distances are rounded to the nearest integer, the integral types are
+// exact, and uint16_t quarters the memory of the distance matrix w.r.t. double.
+enum class DistanceType { DOUBLE, INT32, UINT16 };
+
+// Convert the name of a distance type to its DistanceType value
+inline DistanceType parse_distance_type(const std::string& name) {
+    if (name == "double") {
+        return DistanceType::DOUBLE;
+    } else if (name == "int32") {
+        return DistanceType::INT32;
+    } else if (name == "uint16") {
+        return DistanceType::UINT16;
+    }
+
+    using namespace std::string_literals;
+    throw std::runtime_error("Unsupported distance type: "s + name);
+}
+
+// Return the DistanceType value of the numeric type T
+template <typename T>
+constexpr DistanceType distance_type_of() noexcept {
+    if constexpr (std::is_same_v<T, int32_t>) {
+        return DistanceType::INT32;
+    } else if constexpr (std::is_same_v<T, uint16_t>) {
+        return DistanceType::UINT16;
+    } else {
+        static_assert(std::is_same_v<T, double>, "Unsupported distance type");
+        return DistanceType::DOUBLE;
+    }
+}
+
+// Call the generic function f with a default-constructed value of the numeric type identified by
+// distance_type, so that f can instantiate its templates with decltype of its argument.
+template <class Function>
+decltype(auto) visit_distance_type(DistanceType distance_type, Function&& f) {
+    switch (distance_type) {
+    case DistanceType::INT32:
+        return f(int32_t());
+    case DistanceType::UINT16:
+        return f(uint16_t());
+    default:
+        return f(double());
+    }
+}
@@ -0,0 +1,81 @@
+#pragma once
+
+#include <utility>  // std::pair
+
+#include "CoordinateDistances.h"
+#include "DistanceMatrix.h"
+
+/**
+ * Distances is a lightweight, copyable view over the distance provider of a TSP instance: either
+ * a precomputed DistanceMatrix or a CoordinateDistances oracle that computes distances on demand.
+ * It's the common interface through which paths, heuristics and local searches read distances.
+ * The provider is chosen once per instance, so the branch in each method is always predicted.
+ * The viewed provider must outlive the view.
+ */
+template <typename T = double>
+class Distances {
+    const DistanceMatrix<T>* distance_matrix = nullptr;
+    const CoordinateDistances<T>* coordinate_distances = nullptr;
+
+public:
+    Distances(const DistanceMatrix<T>& distance_matrix) noexcept :
+        distance_matrix(&distance_matrix) {
+    }
+
+    Distances(const CoordinateDistances<T>& coordinate_distances) noexcept :
+        coordinate_distances(&coordinate_distances) {
+    }
+
+    // Return the number of vertexes
+    [[nodiscard]] size_t size() const noexcept {
+        return this->distance_matrix != nullptr ? this->distance_matrix->size()
+                                                : this->coordinate_distances->size();
+    }
+
+    // Return the distance between the i-th and the j-th vertex
+    [[nodiscard]] T at(size_t i, size_t j) const noexcept {
+        return this->distance_matrix != nullptr ? this->distance_matrix->at(i, j)
+                                                : this->coordinate_distances->at(i, j);
+    }
+
+    // Compute the distance between the i-th vertex and each vertex in [first, last), and store
+    // them in out, which must have room for last - first values
+    void distances(size_t i, const size_t* first, const size_t* last, T* out) const noexcept {
+        if (this->distance_matrix != nullptr) {
+            for (; first != last; ++first, ++out) {
+                *out = this->distance_matrix->at(i, *first);
+            }
+        } else {
+            this->coordinate_distances->distances(i, first, last, out);
+        }
+    }
+
+    // Compute the distance between the i-th vertex and every vertex, and store them in out, which
+    // must have room for size() values
+    void row(size_t i, T* out) const noexcept {
+        if (this->distance_matrix != nullptr) {
+            for (size_t j = 0; j < this->distance_matrix->size(); ++j) {
+                out[j] = this->distance_matrix->at(i, j);
+            }
+        } else {
+            this->coordinate_distances->row(i, out);
+        }
+    }
+
+    // Return the two farthest vertexes
+    [[nodiscard]] std::pair<size_t, size_t> get_2_farthest_vertexes() const {
+        return this->distance_matrix != nullptr
+                   ? this->distance_matrix->get_2_farthest_vertexes()
+                   : this->coordinate_distances->get_2_farthest_vertexes();
+    }
+
+    // Two views are equal when they refer to the same provider
+    friend bool operator==(const Distances<T>& lhs, const Distances<T>& rhs) noexcept {
+        return lhs.distance_matrix == rhs.distance_matrix &&
+               lhs.coordinate_distances == rhs.coordinate_distances;
+    }
+
+    friend bool operator!=(const Distances<T>& lhs, const Distances<T>& rhs) noexcept {
+        return !(lhs == rhs);
+    }
+};
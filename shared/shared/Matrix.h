@@ -3,6 +3,7 @@
 #include <iomanip>   // std::setw
 #include <iostream>  // std::ostream
 #include <iterator>  // std::forward_iterator_tag
+#include <utility>   // std::move, std::pair
 #include <vector>    // std::vector
 
 /**
@@ -34,8 +35,13 @@ public:
         rows(rows), cols(cols), data(vec) {
     }
 
+    explicit Matrix(size_t rows, size_t cols, std::vector<T>&& vec) noexcept :
+        rows(rows), cols(cols), data(std::move(vec)) {
+    }
+
     // iterator for the upper triangle of the matrix, useful for computing the maximum/minimum value
-    // in O(n/2)
+    // in O(n/2). If packed is true, the values are expected to be stored as the rows of the upper
+    // triangle (main diagonal included) laid out one after the other.
     template <typename V>
     struct upper_triangular_iterator {
         using iterator_t = upper_triangular_iterator<V>;
@@ -46,10 +52,13 @@ public:
         using difference_type = std::ptrdiff_t;
         using iterator_category = std::forward_iterator_tag;
 
-        explicit upper_triangular_iterator(pointer p, size_t N, size_t row, size_t column) :
-            p(p), N(N), row(row), column(column) {
+        explicit upper_triangular_iterator(pointer p, size_t N, size_t row, size_t column,
+                                           bool packed = false) :
+            p(p), N(N), row(row), column(column), packed(packed), index(get_index()) {
         }
 
+        upper_triangular_iterator(const iterator_t& other) = default;
+
         // Copy-assignment operator
         iterator_t& operator=(const iterator_t& other) {
             if (this != &other) {
@@ -57,25 +66,29 @@ public:
                 N = other.N;
                 row = other.row;
                 column = other.column;
+                packed = other.packed;
+                index = other.index;
             }
 
             return *this;
         }
 
         reference operator*() {
-            return *std::next(p, row * N + column);
+            return *std::next(p, index);
         }
 
         const_reference operator*() const {
-            return *std::next(p, row * N + column);
+            return *std::next(p, index);
         }
 
         iterator_t& operator++() {
             if (column == N - 1) {
                 ++row;
                 column = row + 1;
+                index = get_index();
             } else {
                 ++column;
+                ++index;
             }
 
             return *this;
@@ -101,6 +114,16 @@ public:
         size_t N;
         size_t row;
         size_t column;
+        bool packed;
+
+        // position of (row, column) in the vector pointed by p
+        size_t index;
+
+        // Maps the current (row, column) pair to a vector index. In the packed layout, each row
+        // before the current one is shorter than N by its own row number.
+        [[nodiscard]] size_t get_index() const noexcept {
+            return row * N + column - packed * (row * (row + 1) / 2);
+        }
     };
 
     // Getter for rows
@@ -0,0 +1,150 @@
+#pragma once
+
+#include <algorithm>  // std::partial_sort, std::transform, std::copy, std::min
+#include <iterator>   // std::next
+#include <utility>    // std::pair, std::forward
+#include <vector>     // std::vector
+
+#include "Distances.h"
+#include "spatial_utils/utils.h"
+
+/**
+ * NeighborLists stores, for each vertex of a complete graph, its k nearest vertexes sorted by
+ * increasing distance. They're used as candidate lists, i.e. to restrict the local search moves
+ * to the edges that are likely to belong to a good circuit.
+ * It stores its values in a contiguous 1D vector of size n * k.
+ */
+class NeighborLists {
+    size_t n_vertexes;
+    size_t k;
+    std::vector<size_t> data;
+
+    // Fill the candidate list of each vertex according to the fill_row(i, row) function, which
+    // stores in row[j] the distance between the i-th and the j-th vertex
+    template <typename FillRow>
+    void init(const FillRow& fill_row) {
+        using candidate_t = std::pair<double, size_t>;
+
+        // reused for every vertex, they store the distance of every other vertex
+        std::vector<double> row(n_vertexes);
+        std::vector<candidate_t> candidates;
+        candidates.reserve(n_vertexes);
+
+        for (size_t i = 0; i < n_vertexes; ++i) {
+            fill_row(i, row);
+            candidates.clear();
+
+            for (size_t j = 0; j < n_vertexes; ++j) {
+                if (j != i) {
+                    candidates.emplace_back(row[j], j);
+                }
+            }
+
+            // only the k nearest vertexes need to be sorted
+            const auto middle = std::next(candidates.begin(), k);
+            std::partial_sort(candidates.begin(), middle, candidates.end());
+
+            std::transform(candidates.begin(), middle, std::next(data.begin(), i * k),
+                           [](const candidate_t& candidate) { return candidate.second; });
+        }
+    }
+
+public:
+    explicit NeighborLists() noexcept : n_vertexes(0), k(0), data() {
+    }
+
+    // Create the candidate lists of the k nearest vertexes of each of the n_vertexes vertexes.
+    // distance(i, j) returns the distance between the i-th and j-th point.
+    // k is clipped to n_vertexes - 1.
+    template <typename Distance>
+    NeighborLists(size_t n_vertexes, size_t k, Distance&& distance) :
+        n_vertexes(n_vertexes),
+        k(n_vertexes > 0 ? std::min(k, n_vertexes - 1) : 0),
+        data(this->n_vertexes * this->k) {
+        init([&distance, n_vertexes](size_t i, std::vector<double>& row) {
+            for (size_t j = 0; j < n_vertexes; ++j) {
+                row[j] = static_cast<double>(distance(i, j));
+            }
+        });
+    }
+
+    // Create the candidate lists of the k nearest vertexes of each vertex of the given distance
+    // provider. The distances from each vertex are computed in a single batch.
+    // k is clipped to distances.size() - 1.
+    template <typename T>
+    NeighborLists(const Distances<T>& distances, size_t k) :
+        n_vertexes(distances.size()),
+        k(n_vertexes > 0 ? std::min(k, n_vertexes - 1) : 0),
+        data(this->n_vertexes * this->k) {
+        std::vector<T> distances_row(n_vertexes);
+
+        init([&distances, &distances_row](size_t i, std::vector<double>& row) {
+            distances.row(i, distances_row.data());
+            std::copy(distances_row.cbegin(), distances_row.cend(), row.begin());
+        });
+    }
+
+    // Create the candidate lists of the k nearest vertexes of each of the n_vertexes points of
+    // the given spatial index (see spatial::KDTree), in O(n k log n) rather than O(n²). The
+    // vertexes are ranked by Euclidean distance, which preserves the order of any metric that is
+    // a non-decreasing function of it. k is clipped to n_vertexes - 1.
+    template <class SpatialIndex>
+    [[nodiscard]] static NeighborLists from_spatial_index(size_t n_vertexes,
+                                                          const SpatialIndex& index, size_t k) {
+        NeighborLists neighbor_lists;
+        neighbor_lists.n_vertexes = n_vertexes;
+        neighbor_lists.k = n_vertexes > 0 ? std::min(k, n_vertexes - 1) : 0;
+        neighbor_lists.data.resize(n_vertexes * neighbor_lists.k);
+
+        // reused for every vertex
+        std::vector<size_t> nearest;
+        nearest.reserve(neighbor_lists.k);
+
+        for (size_t i = 0; i < n_vertexes; ++i) {
+            spatial::k_nearest(index, i, neighbor_lists.k, nearest);
+            std::copy(nearest.cbegin(), nearest.cend(),
+                      std::next(neighbor_lists.data.begin(), i * neighbor_lists.k));
+        }
+
+        return neighbor_lists;
+    }
+
+    // Create the candidate lists from the given rows of stored_k sorted neighbors per vertex,
+    // e.g. precomputed ones. Only the first k neighbors of each row are kept.
+    // k is clipped to stored_k.
+    template <typename Index>
+    [[nodiscard]] static NeighborLists from_rows(size_t n_vertexes, size_t stored_k, size_t k,
+                                                 const Index* rows) {
+        NeighborLists neighbor_lists;
+        neighbor_lists.n_vertexes = n_vertexes;
+        neighbor_lists.k = std::min(k, stored_k);
+        neighbor_lists.data.resize(n_vertexes * neighbor_lists.k);
+
+        for (size_t i = 0; i < n_vertexes; ++i) {
+            std::copy(rows + i * stored_k, rows + i * stored_k + neighbor_lists.k,
+                      std::next(neighbor_lists.data.begin(), i * neighbor_lists.k));
+        }
+
+        return neighbor_lists;
+    }
+
+    // Return the number of vertexes
+    [[nodiscard]] size_t size() const noexcept {
+        return n_vertexes;
+    }
+
+    // Return the number of neighbors stored for each vertex
+    [[nodiscard]] size_t neighbors_per_vertex() const noexcept {
+        return k;
+    }
+
+    // Return the first of the nearest neighbors of vertex i
+    [[nodiscard]] const size_t* begin(size_t i) const noexcept {
+        return data.data() + i * k;
+    }
+
+    // Return the end of the nearest neighbors of vertex i
+    [[nodiscard]] const size_t* end(size_t i) const noexcept {
+        return data.data() + (i + 1) * k;
+    }
+};
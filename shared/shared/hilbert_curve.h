@@ -0,0 +1,69 @@
+#pragma once
+
+#include <algorithm>  // std::minmax_element, std::max, std::sort, std::swap
+#include <cstdint>    // uint32_t, uint64_t
+#include <numeric>    // std::iota
+#include <vector>     // std::vector
+
+/**
+ * Hilbert space-filling curve over a 2^ORDER × 2^ORDER grid. Points that are close along the
+ * curve are close in the plane, so numbering the cities in curve order keeps the cities that are
+ * adjacent in a good circuit in nearby rows of the distance matrix.
+ */
+namespace hilbert_curve {
+    // number of bits of each quantized coordinate
+    constexpr uint32_t ORDER = 16;
+
+    // Return the position of the cell (x, y) along the curve, with x, y in [0, 2^ORDER)
+    [[nodiscard]] inline uint64_t index(uint32_t x, uint32_t y) noexcept {
+        constexpr uint32_t side = uint32_t(1) << ORDER;
+        uint64_t d = 0;
+
+        for (uint32_t s = side / 2; s > 0; s /= 2) {
+            const uint32_t rx = (x & s) > 0 ? 1 : 0;
+            const uint32_t ry = (y & s) > 0 ? 1 : 0;
+            d += uint64_t(s) * s * ((3 * rx) ^ ry);
+
+            // rotate the quadrant, so that the sub-curve is traversed in the right direction
+            if (ry == 0) {
+                if (rx == 1) {
+                    x = side - 1 - x;
+                    y = side - 1 - y;
+                }
+                std::swap(x, y);
+            }
+        }
+
+        return d;
+    }
+
+    // Return the indexes of the points (x[i], y[i]) sorted along the curve: the i-th point of
+    // the curve is the order[i]-th point. The bounding box of the points is scaled to the grid,
+    // and the ties are broken by index, so the order is deterministic.
+    [[nodiscard]] inline std::vector<size_t> sort(const std::vector<double>& x,
+                                                  const std::vector<double>& y) {
+        std::vector<size_t> order(x.size());
+        std::iota(order.begin(), order.end(), 0);
+
+        if (x.empty()) {
+            return order;
+        }
+
+        const auto [x_min, x_max] = std::minmax_element(x.cbegin(), x.cend());
+        const auto [y_min, y_max] = std::minmax_element(y.cbegin(), y.cend());
+        const double side = std::max(*x_max - *x_min, *y_max - *y_min);
+        const double scale = side > 0 ? ((uint32_t(1) << ORDER) - 1) / side : 0.0;
+
+        std::vector<uint64_t> keys(x.size());
+        for (size_t i = 0; i < x.size(); ++i) {
+            keys[i] = index(static_cast<uint32_t>((x[i] - *x_min) * scale),
+                            static_cast<uint32_t>((y[i] - *y_min) * scale));
+        }
+
+        std::sort(order.begin(), order.end(), [&keys](size_t a, size_t b) {
+            return keys[a] < keys[b] || (keys[a] == keys[b] && a < b);
+        });
+
+        return order;
+    }
+}  // namespace hilbert_curve
@@ -1,109 +1,229 @@
 ﻿#pragma once
 
-#include <iostream>  // std::ostream
-#include <iterator>  // std::ostream_iterator
-#include <limits>    // std::numeric_limits
-#include <string>    // std::separator
-#include <vector>    // std::vector
-
-#include "../DistanceMatrix.h"
+#include <algorithm>    // std::copy, std::swap_ranges
+#include <cstdint>      // uint16_t, uint32_t
+#include <iostream>     // std::ostream
+#include <limits>       // std::numeric_limits
+#include <numeric>      // std::iota
+#include <string>       // std::separator
+#include <type_traits>  // std::is_unsigned_v, std::is_same_v, std::enable_if_t
+#include <vector>       // std::vector
+
+#include "../Distances.h"
 #include "utils.h"
 
 // PermutationPath represents a TSP path as a permutation of a vector [0, 1, ..., n-1], where n is
 // the number of cities in the problem.
 // All copy-assignments and move-assignments between different PermutationPath must refer to the
-// same common DistanceMatrix.
-// The type T indicates the type of the distance between each two cities.
-template <typename T = double>
+// same common distance provider (see Distances).
+// The type T indicates the type of the distance between each two cities, while cost_t is the type
+// of the circuit distance and of its variations (see utils::cost_t).
+// The type Index indicates the type of the cities stored in the path. It's uint32_t by default, and
+// uint16_t can be used for instances with up to 65536 cities: the smaller the index, the fewer
+// bytes are copied whenever a path is copied, and the more paths fit in the CPU caches.
+// A path can also be a view over cities and a memoized cost stored elsewhere, e.g. in the slab of
+// a PopulationPool. Assigning to a view copies the cities in place, so its size never changes,
+// while copying or moving a view into a new PermutationPath yields a path that owns its cities.
+template <typename T = double, typename Index = uint32_t>
 class PermutationPath {
-    using path_t = std::vector<size_t>;
-    using iterator = path_t::iterator;
-    using const_iterator = path_t::const_iterator;
+    static_assert(std::is_unsigned_v<Index>, "Index must be an unsigned integral type");
+
+public:
+    using cost_t = utils::cost_t<T>;
+    using index_t = Index;
+
+    // Return true if a path of n cities can be stored with the given Index type
+    [[nodiscard]] static constexpr bool can_store(size_t n) noexcept {
+        return n == 0 || n - 1 <= std::numeric_limits<Index>::max();
+    }
+
+private:
+    using path_t = std::vector<Index>;
+    using iterator = Index*;
+    using const_iterator = const Index*;
 
     // Initial circuit distance of this path. Since the distance for the same solution might
     // get compute multiple times and it's quite expensive (linear to the size of the path),
     // it is computed lazily and memoized for future calls to PermutationPath<T>::cost().
-    static constexpr T DISTANCE_NOT_COMPUTED = std::numeric_limits<T>::max();
+    static constexpr cost_t DISTANCE_NOT_COMPUTED = std::numeric_limits<cost_t>::max();
 
-    // It contains the path represented as a permutation of [0, 1, ..., n - 1]
+    // Cities owned by this path. It's empty if the path is a view.
     path_t path;
 
-    // Contant reference to the distance matrix of this permutation path
-    const DistanceMatrix<T>& distance_matrix;
+    // It contains the path represented as a permutation of [0, 1, ..., n - 1], either
+    // path.data() or the cities of a view
+    Index* cities;
+
+    // Number of cities in the path
+    size_t n_cities;
+
+    // View over the distance matrix or the distance oracle of this permutation path
+    Distances<T> distances;
 
     // Circuit distance of the path: δ(path[0], path[1]) + ... + δ(path[n - 1], path[0]).
     // distance is mutable so that PermutationPath<T>::cost() is a const method.
-    mutable T distance = DISTANCE_NOT_COMPUTED;
+    mutable cost_t distance = DISTANCE_NOT_COMPUTED;
+
+    // Memoized circuit distance, either &distance or the cost of a view
+    cost_t* memo;
 
     // Return the distance between any 2 nodes
     T get_distance_helper(const size_t x, const size_t y) const {
-        return this->distance_matrix.at(x, y);
+        return this->distances.at(x, y);
+    }
+
+    // Return true if the cities are stored elsewhere
+    [[nodiscard]] bool is_view() const noexcept {
+        return this->memo != &this->distance;
+    }
+
+    // Point cities to the owned cities, e.g. after path has been moved or reassigned
+    void own_cities() noexcept {
+        this->cities = this->path.data();
+        this->n_cities = this->path.size();
+    }
+
+    // Copy the cities in [first, last) into this path. A view keeps its size, so the range must
+    // have exactly size() cities.
+    void assign_cities(const Index* first, const Index* last) {
+        if (this->is_view()) {
+            if (first != this->cities) {
+                std::copy(first, last, this->cities);
+            }
+        } else {
+            this->path.assign(first, last);
+            this->own_cities();
+        }
     }
 
 public:
-    template <typename V>
-    static PermutationPath<V> from_size(size_t n,
-                                        const DistanceMatrix<V>& distance_matrix) noexcept {
-        return PermutationPath<V>(utils::vector_in_range(0, n), distance_matrix);
+    static PermutationPath from_size(size_t n, Distances<T> distances) noexcept {
+        path_t path(n);
+        std::iota(path.begin(), path.end(), Index(0));
+        return PermutationPath(std::move(path), distances);
+    }
+
+    explicit PermutationPath(const path_t& path, Distances<T> distances) :
+        path(path),
+        cities(this->path.data()),
+        n_cities(this->path.size()),
+        distances(distances),
+        memo(&this->distance) {
     }
 
-    explicit PermutationPath(const path_t& path, const DistanceMatrix<T>& distance_matrix) :
-        path(path), distance_matrix(distance_matrix) {
+    explicit PermutationPath(path_t&& path, Distances<T> distances) :
+        path(std::move(path)),
+        cities(this->path.data()),
+        n_cities(this->path.size()),
+        distances(distances),
+        memo(&this->distance) {
     }
 
-    explicit PermutationPath(path_t&& path, const DistanceMatrix<T>& distance_matrix) :
-        path(std::move(path)), distance_matrix(distance_matrix) {
+    // Narrow a path whose cities are stored with a different type, e.g. the std::vector<size_t>
+    // computed by a construction heuristic
+    template <typename OtherIndex,
+              typename = std::enable_if_t<!std::is_same_v<OtherIndex, Index>>>
+    explicit PermutationPath(const std::vector<OtherIndex>& path, Distances<T> distances) :
+        path(path.cbegin(), path.cend()),
+        cities(this->path.data()),
+        n_cities(this->path.size()),
+        distances(distances),
+        memo(&this->distance) {
     }
 
-    // Copy constructor
-    PermutationPath(const PermutationPath<T>& other) noexcept :
-        path(other.path), distance_matrix(other.distance_matrix), distance(other.distance) {
+    // Wrap the n cities stored in cities, without copying them. The memoized cost is stored in
+    // *cost, which is reset. Both must outlive the view.
+    explicit PermutationPath(Index* cities, size_t n, cost_t* cost,
+                             Distances<T> distances) noexcept :
+        cities(cities), n_cities(n), distances(distances), memo(cost) {
+        *this->memo = DISTANCE_NOT_COMPUTED;
     }
 
-    // Move constructor
-    PermutationPath(PermutationPath<T>&& other) noexcept :
-        path(std::move(other.path)),
-        distance_matrix(other.distance_matrix),
-        distance(other.distance) {
+    // Copy constructor. The copy always owns its cities.
+    PermutationPath(const PermutationPath& other) noexcept :
+        path(other.cbegin(), other.cend()),
+        cities(this->path.data()),
+        n_cities(other.n_cities),
+        distances(other.distances),
+        distance(*other.memo),
+        memo(&this->distance) {
     }
 
-    PermutationPath<T>& operator=(const PermutationPath<T>& other) noexcept {
-        if (this != &other && &(this->distance_matrix) == &(other.distance_matrix)) {
-            this->path = other.path;
-            this->distance = other.distance;
+    // Move constructor. The cities of a view are copied rather than stolen.
+    PermutationPath(PermutationPath&& other) noexcept :
+        path(other.is_view() ? path_t(other.cbegin(), other.cend()) : std::move(other.path)),
+        cities(this->path.data()),
+        n_cities(this->path.size()),
+        distances(other.distances),
+        distance(*other.memo),
+        memo(&this->distance) {
+        if (!other.is_view()) {
+            other.own_cities();
+        }
+    }
+
+    PermutationPath& operator=(const PermutationPath& other) noexcept {
+        if (this != &other && this->distances == other.distances) {
+            this->assign_cities(other.cbegin(), other.cend());
+            *this->memo = *other.memo;
         }
 
         return *this;
     }
 
-    PermutationPath<T>& operator=(PermutationPath<T>&& other) noexcept {
-        if (this != &other && &(this->distance_matrix) == &(other.distance_matrix)) {
-            this->path = std::move(other.path);
-            this->distance = other.distance;
+    PermutationPath& operator=(PermutationPath&& other) noexcept {
+        if (this != &other && this->distances == other.distances) {
+            if (this->is_view() || other.is_view()) {
+                this->assign_cities(other.cbegin(), other.cend());
+            } else {
+                this->path = std::move(other.path);
+                this->own_cities();
+                other.own_cities();
+            }
+
+            *this->memo = *other.memo;
         }
 
         return *this;
     }
 
     // Lazily compute the total cost of the solution and memoize it for future reference.
-    [[nodiscard]] T cost() const noexcept {
-        if (this->distance == DISTANCE_NOT_COMPUTED) {
+    [[nodiscard]] cost_t cost() const noexcept {
+        if (*this->memo == DISTANCE_NOT_COMPUTED) {
             auto get_distance = [this](const size_t x, const size_t y) -> T {
                 return this->get_distance_helper(x, y);
             };
 
             // Compute the circuit distance
-            this->distance =
+            *this->memo =
                 utils::sum_distances_as_circuit(this->cbegin(), this->cend(), get_distance);
         }
 
-        return this->distance;
+        return *this->memo;
     }
 
     // Reset cost.
-    // TODO: add way to compute updated cost after mutation without recomputing everything.
-    void reset_cost(T new_distance = DISTANCE_NOT_COMPUTED) noexcept {
-        this->distance = new_distance;
+    void reset_cost(cost_t new_distance = DISTANCE_NOT_COMPUTED) noexcept {
+        *this->memo = new_distance;
+    }
+
+    // Shift the memoized cost by the given delta, e.g. after an in-place mutation whose cost
+    // variation has been computed in O(1). If the cost hasn't been computed yet, it stays lazy.
+    void update_cost(cost_t delta) noexcept {
+        if (*this->memo != DISTANCE_NOT_COMPUTED) {
+            *this->memo += delta;
+        }
+    }
+
+    // Return the view over the distances between the cities of this path
+    [[nodiscard]] const Distances<T>& get_distances() const noexcept {
+        return this->distances;
+    }
+
+    // Return the distance between the cities x and y, widened to cost_t so that it can be summed
+    // and subtracted safely
+    [[nodiscard]] cost_t distance_between(const size_t x, const size_t y) const noexcept {
+        return this->get_distance_helper(x, y);
     }
 
     /**
@@ -115,61 +235,78 @@ public:
      */
 
     iterator begin() noexcept {
-        return path.begin();
+        return this->cities;
     }
 
     iterator end() noexcept {
-        return path.end();
+        return this->cities + this->n_cities;
     }
 
     const_iterator begin() const noexcept {
-        return path.begin();
+        return this->cities;
     }
 
     const_iterator end() const noexcept {
-        return path.end();
+        return this->cities + this->n_cities;
     }
 
     const_iterator cbegin() const noexcept {
-        return path.cbegin();
+        return this->cities;
     }
 
     const_iterator cend() const noexcept {
-        return path.cend();
+        return this->cities + this->n_cities;
     }
 
-    size_t& operator[](size_t i) {
-        return path[i];
+    Index& operator[](size_t i) {
+        return this->cities[i];
     }
 
-    const size_t& operator[](size_t i) const {
-        return path[i];
+    const Index& operator[](size_t i) const {
+        return this->cities[i];
     }
 
     size_t size() const noexcept {
-        return path.size();
+        return this->n_cities;
     }
 
-    template <typename V>
-    friend void swap(PermutationPath<V>& a, PermutationPath<V>& b) {
+    // Swap the cities and the costs of two paths. Owned cities are swapped in O(1), while the
+    // cities of a view are swapped in place, so the two paths must have the same size.
+    friend void swap(PermutationPath& a, PermutationPath& b) {
         using std::swap;
-        swap(a.path, b.path);
-        swap(a.distance, b.distance);
+
+        if (a.is_view() || b.is_view()) {
+            std::swap_ranges(a.begin(), a.end(), b.begin());
+        } else {
+            swap(a.path, b.path);
+            a.own_cities();
+            b.own_cities();
+        }
+
+        swap(*a.memo, *b.memo);
     }
 
     /**
-     * Pretty-print a permutation path
+     * Pretty-print a permutation path, printing label(city) in place of each city, e.g. the label
+     * the city had before the cities were renumbered
      */
-    friend std::ostream& operator<<(std::ostream& os, const PermutationPath<T>& permutation_path) {
+    template <class Label>
+    void print(std::ostream& os, Label&& label) const {
         const char* separator = "->";
-        auto&& path = permutation_path.path;
 
-        // this leaves a trailing separator
-        std::copy(path.begin(), path.end(), std::ostream_iterator<size_t>(os, separator));
+        for (const size_t city : *this) {
+            os << label(city) << separator;
+        }
 
         // print the first element of the path again to represent a circuit
-        os << path[0];
+        os << label(this->cities[0]);
+    }
 
+    /**
+     * Pretty-print a permutation path
+     */
+    friend std::ostream& operator<<(std::ostream& os, const PermutationPath& permutation_path) {
+        permutation_path.print(os, [](size_t city) { return city; });
         return os;
     }
 };
@@ -1,20 +1,28 @@
 ﻿#pragma once
 
-#include <iterator>  // std::next
-#include <numeric>   // std::iota
-#include <vector>    // std::vector
+#include <cstdint>      // int64_t
+#include <iterator>     // std::next
+#include <numeric>      // std::iota
+#include <type_traits>  // std::conditional_t, std::is_integral_v, std::decay_t
+#include <vector>       // std::vector
 
 namespace utils {
+    // Type of the sums and differences of distances of type T, e.g. circuit costs and cost
+    // variations. Integral distances are accumulated in signed 64-bit integers, so that narrow
+    // distance types neither overflow nor wrap around on negative variations.
+    template <typename T>
+    using cost_t = std::conditional_t<std::is_integral_v<T>, int64_t, T>;
+
     // Compute the total distance of the circuit path [start, ..., end, start].
     template <class ForwardIt, typename Distance>
     auto sum_distances_as_circuit(const ForwardIt& start, const ForwardIt& end,
                                   Distance&& get_distance) noexcept {
-        using distance_t = decltype(get_distance(0, 0));
+        using distance_t = cost_t<std::decay_t<decltype(get_distance(0, 0))>>;
         auto circuit_distance = distance_t(0);
         auto it_prev = start;
 
         for (auto it_curr = std::next(start, 1); it_curr != end; ++it_curr) {
-            auto distance = get_distance(*it_curr, *it_prev);
+            const distance_t distance = get_distance(*it_curr, *it_prev);
             circuit_distance += distance;
             ++it_prev;
         }
@@ -1,72 +1,39 @@
 #pragma once
 
-#include <fstream>    // std::fstream, std::fstream
-#include <limits>     // std::numeric_limits
-#include <memory>     // std::unique_ptr
-#include <stdexcept>  // std::exception
-#include <string>     // std::string, std::string_literals
+#include <memory>       // std::unique_ptr, std::shared_ptr, std::make_shared
+#include <string_view>  // std::string_view
+#include <utility>      // std::move
 
 #include "read_tsp_utils/EdgeWeightType.h"
+#include "read_tsp_utils/MappedFile.h"
+#include "read_tsp_utils/binary_instance.h"
 #include "read_tsp_utils/point_reader_factory.h"
-#include "read_tsp_utils/utils.h"
+#include "read_tsp_utils/tsplib_parser.h"
 
-// skip n_skip chars while reading from file
-inline void skip_chars(std::fstream& file,
-                       std::streamsize n_skip = std::numeric_limits<std::streamsize>::max(),
-                       const char delimiter = '\n') {
-    file.ignore(n_skip, delimiter);
-}
-
-// skip a line while reading from file
-inline void skip_line(std::fstream& file) {
-    skip_chars(file);
-}
-
-// read a TSP file definition, skipping the unimportant header parts
+// read a TSP file definition, either in the TSPLIB format or in the binary instance format.
+// The file is memory-mapped and parsed in place; if filename is "-", the definition is read from
+// the standard input instead.
 inline std::unique_ptr<point_reader::PointReader> read_tsp_file(const char* filename) {
-    using namespace std::string_literals;
-
-    std::fstream file(filename);
-    if (!file.good()) {
-        throw std::runtime_error("File doesn't exist"s);
+    auto file(std::make_shared<const MappedFile>(
+        std::string_view(filename) == "-" ? MappedFile::from_stdin() : MappedFile(filename)));
+
+    if (binary_instance::is_binary_instance(file->view())) {
+        // the mapping is kept alive by the point reader, so that its distance matrix can be used
+        // without copying it
+        auto instance(std::make_shared<const binary_instance::MappedInstance>(std::move(file)));
+
+        tsplib::Instance points;
+        points.dimension = instance->dimension();
+        points.edge_weight_type = instance->edge_weight_type();
+        instance->get_coordinates(points.x, points.y);
+
+        auto point_reader(point_reader::point_reader_factory(std::move(points)));
+        point_reader->set_precomputed(std::move(instance));
+        return point_reader;
     }
 
-    skip_line(file);  // skip NAME line
-    skip_line(file);  // skip TYPE/COMMENT line
-    skip_line(file);  // skip COMMENT/TYPE line
-
-    skip_chars(file, utils::string_length("DIMENSION:"));
-
-    // read dimension of the graph
-    size_t dimension;
-    file >> dimension;
-    skip_line(file);  // skip to next line after reading dimension
-
-    skip_chars(file, utils::string_length("EDGE_WEIGHT_TYPE:"));
-
-    // read type of coordinates. The distance measure will depend on this would
-    EdgeWeightType edge_weight_type;
-    file >> edge_weight_type;
-    skip_line(file);  // skip to next line after reading edge_weight_type
-
-    // skip lines until "NODE_COORD_SECTION" string
-    std::string line;
-    bool stop = false;
-    while (!stop) {
-        std::getline(file, line);
-        if (line.find("NODE_COORD_SECTION") == 0) {
-            stop = true;
-        }
-    }
-
-    // point_reader knows how to read the points according to their type (determined by
-    // edge_weight_type). After reading the points, it creates the distance matrix using the correct
-    // distance function, i.e. the geodesic distance for GEO points, and euclidean distance for
-    // EUC_2D.
-    auto point_reader(point_reader::point_reader_factory(edge_weight_type, file, dimension));
-    point_reader->read();
-
-    // release file
-    file.close();
-    return point_reader;
+    // point_reader knows how to compute the distances according to the type of the points
+    // (determined by edge_weight_type), i.e. the geodesic distance for GEO points, and euclidean
+    // distance for EUC_2D.
+    return point_reader::point_reader_factory(tsplib::parse(file->view()));
 }
@@ -0,0 +1,81 @@
+#pragma once
+
+#include <cstdint>  // int32_t, uint16_t
+#include <utility>  // std::move
+#include <vector>   // std::vector
+
+#include "../CoordinateDistances.h"
+#include "../DistanceMatrix.h"
+#include "EdgeWeightType.h"
+#include "PointReader.h"
+
+namespace point_reader {
+    /**
+     * PointReader implementation for 2D points, whose distances are computed from their
+     * coordinates according to a TSPLIB metric (EUC_2D, CEIL_2D, ATT, MAN_2D or GEO).
+     */
+    class CoordinatePointReader : public PointReader {
+        using super = PointReader;
+
+        EdgeWeightType metric;
+
+        // coordinates of the points, stored as a structure of arrays indexed by the vertex' label
+        std::vector<double> x;
+        std::vector<double> y;
+
+        // build the distance matrix from a temporary distance oracle, which computes each row
+        // with the inlined distance functor of the metric
+        template <typename T>
+        [[nodiscard]] DistanceMatrix<T> make_distance_matrix(DistanceMatrixLayout layout) const {
+            return DistanceMatrix<T>(CoordinateDistances<T>(x, y, metric), layout);
+        }
+
+    protected:
+        [[nodiscard]] DistanceMatrix<double> build_distance_matrix(DistanceMatrixLayout layout,
+                                                                   double) const override {
+            return make_distance_matrix<double>(layout);
+        }
+
+        [[nodiscard]] DistanceMatrix<int32_t> build_distance_matrix(DistanceMatrixLayout layout,
+                                                                    int32_t) const override {
+            return make_distance_matrix<int32_t>(layout);
+        }
+
+        [[nodiscard]] DistanceMatrix<uint16_t> build_distance_matrix(DistanceMatrixLayout layout,
+                                                                     uint16_t) const override {
+            return make_distance_matrix<uint16_t>(layout);
+        }
+
+        // store the coordinates of the points in the structure of arrays x[] and y[]
+        void get_coordinates(std::vector<double>& x, std::vector<double>& y) const override {
+            x = this->x;
+            y = this->y;
+        }
+
+        // renumber the points, so that the new i-th point is the old order[i]-th one
+        void reorder(const std::vector<size_t>& order) override {
+            std::vector<double> x(order.size());
+            std::vector<double> y(order.size());
+
+            for (size_t i = 0; i < order.size(); ++i) {
+                x[i] = this->x[order[i]];
+                y[i] = this->y[order[i]];
+            }
+
+            this->x = std::move(x);
+            this->y = std::move(y);
+        }
+
+    public:
+        // store the coordinates of the dimension = x.size() points, whose distances are measured
+        // with the given metric
+        CoordinatePointReader(EdgeWeightType metric, std::vector<double> x,
+                              std::vector<double> y) :
+            super(x.size()), metric(metric), x(std::move(x)), y(std::move(y)) {
+        }
+
+        [[nodiscard]] EdgeWeightType edge_weight_type() const noexcept override {
+            return metric;
+        }
+    };
+}  // namespace point_reader
@@ -1,25 +1,53 @@
 #pragma once
 
-#include <iostream>   // std::istream
-#include <stdexcept>  // std::runtime_error
-#include <string>     // std::string_literals
+#include <stdexcept>    // std::runtime_error
+#include <string>       // std::string, std::string_literals
+#include <string_view>  // std::string_view
 
 // enumeration of the supported metric distances
 enum class EdgeWeightType {
-    EUC_2D  // euclidean 2-dimensional distance
+    EUC_2D,   // euclidean 2-dimensional distance
+    CEIL_2D,  // euclidean 2-dimensional distance rounded up
+    ATT,      // pseudo-euclidean 2-dimensional distance
+    MAN_2D,   // manhattan 2-dimensional distance
+    GEO,      // geographical distance
+    EXPLICIT  // distances listed in the EDGE_WEIGHT_SECTION
 };
 
-// read a EdgeWeightType object in input
-std::istream& operator>>(std::istream& is, EdgeWeightType& edge_weight_type) {
-    std::string name;
-    is >> name;
+// enumeration of the supported layouts of the EDGE_WEIGHT_SECTION of EXPLICIT instances
+enum class EdgeWeightFormat {
+    FULL_MATRIX,  // every n×n distance, row by row
+    UPPER_ROW     // the triangle above the main diagonal, row by row
+};
 
+// convert the value of the EDGE_WEIGHT_TYPE keyword to its EdgeWeightType
+inline EdgeWeightType parse_edge_weight_type(std::string_view name) {
     if (name == "EUC_2D") {
-        edge_weight_type = EdgeWeightType::EUC_2D;
-    } else {
-        using namespace std::string_literals;
-        throw std::runtime_error("Unsupported EDGE_WEIGHT_TYPE"s);
+        return EdgeWeightType::EUC_2D;
+    } else if (name == "CEIL_2D") {
+        return EdgeWeightType::CEIL_2D;
+    } else if (name == "ATT") {
+        return EdgeWeightType::ATT;
+    } else if (name == "MAN_2D") {
+        return EdgeWeightType::MAN_2D;
+    } else if (name == "GEO") {
+        return EdgeWeightType::GEO;
+    } else if (name == "EXPLICIT") {
+        return EdgeWeightType::EXPLICIT;
+    }
+
+    using namespace std::string_literals;
+    throw std::runtime_error("Unsupported EDGE_WEIGHT_TYPE"s);
+}
+
+// convert the value of the EDGE_WEIGHT_FORMAT keyword to its EdgeWeightFormat
+inline EdgeWeightFormat parse_edge_weight_format(std::string_view name) {
+    if (name == "FULL_MATRIX") {
+        return EdgeWeightFormat::FULL_MATRIX;
+    } else if (name == "UPPER_ROW") {
+        return EdgeWeightFormat::UPPER_ROW;
     }
 
-    return is;
+    using namespace std::string_literals;
+    throw std::runtime_error("Unsupported EDGE_WEIGHT_FORMAT"s);
 }
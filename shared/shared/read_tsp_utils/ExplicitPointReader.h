@@ -0,0 +1,98 @@
+#pragma once
+
+#include <algorithm>    // std::max_element
+#include <cstdint>      // int32_t, uint16_t
+#include <limits>       // std::numeric_limits
+#include <stdexcept>    // std::overflow_error, std::runtime_error
+#include <string>       // std::string_literals
+#include <type_traits>  // std::is_integral_v
+#include <utility>      // std::move, std::swap
+#include <vector>       // std::vector
+
+#include "../DistanceMatrix.h"
+#include "EdgeWeightType.h"
+#include "PointReader.h"
+
+namespace point_reader {
+    /**
+     * PointReader implementation for EXPLICIT instances, whose distances are listed in the file
+     * rather than computed from coordinates.
+     */
+    class ExplicitPointReader : public PointReader {
+        using super = PointReader;
+
+        // distances above the main diagonal, row by row: the distance between i and j > i is
+        // stored at i * dimension - i * (i + 1) / 2 + j - i - 1
+        std::vector<double> weights;
+
+        // return the position of the distance between i and j in weights, with i != j
+        [[nodiscard]] size_t weight_index(size_t i, size_t j) const noexcept {
+            if (i > j) {
+                std::swap(i, j);
+            }
+            return i * dimension - i * (i + 1) / 2 + j - i - 1;
+        }
+
+        template <typename T>
+        [[nodiscard]] DistanceMatrix<T> make_distance_matrix(DistanceMatrixLayout layout) const {
+            if constexpr (std::is_integral_v<T>) {
+                const auto max_weight = std::max_element(weights.cbegin(), weights.cend());
+                if (max_weight != weights.cend() &&
+                    *max_weight > static_cast<double>(std::numeric_limits<T>::max())) {
+                    throw std::overflow_error(
+                        "The distances don't fit in the chosen distance type");
+                }
+            }
+
+            return DistanceMatrix<T>(
+                dimension,
+                [this](size_t i, size_t j) { return static_cast<T>(weights[weight_index(i, j)]); },
+                layout);
+        }
+
+    protected:
+        [[nodiscard]] DistanceMatrix<double> build_distance_matrix(DistanceMatrixLayout layout,
+                                                                   double) const override {
+            return make_distance_matrix<double>(layout);
+        }
+
+        [[nodiscard]] DistanceMatrix<int32_t> build_distance_matrix(DistanceMatrixLayout layout,
+                                                                    int32_t) const override {
+            return make_distance_matrix<int32_t>(layout);
+        }
+
+        [[nodiscard]] DistanceMatrix<uint16_t> build_distance_matrix(DistanceMatrixLayout layout,
+                                                                     uint16_t) const override {
+            return make_distance_matrix<uint16_t>(layout);
+        }
+
+        // EXPLICIT instances have no coordinates
+        void get_coordinates(std::vector<double>&, std::vector<double>&) const override {
+            using namespace std::string_literals;
+            throw std::runtime_error("EXPLICIT instances have no coordinates"s);
+        }
+
+        // renumber the vertexes, so that the new i-th vertex is the old order[i]-th one
+        void reorder(const std::vector<size_t>& order) override {
+            std::vector<double> weights(this->weights.size());
+
+            for (size_t i = 0; i < dimension; ++i) {
+                for (size_t j = i + 1; j < dimension; ++j) {
+                    weights[weight_index(i, j)] = this->weights[weight_index(order[i], order[j])];
+                }
+            }
+
+            this->weights = std::move(weights);
+        }
+
+    public:
+        // store the distances above the main diagonal of the dimension vertexes, row by row
+        ExplicitPointReader(size_t dimension, std::vector<double> weights) :
+            super(dimension), weights(std::move(weights)) {
+        }
+
+        [[nodiscard]] EdgeWeightType edge_weight_type() const noexcept override {
+            return EdgeWeightType::EXPLICIT;
+        }
+    };
+}  // namespace point_reader
@@ -0,0 +1,162 @@
+#pragma once
+
+#include <cstdio>       // std::fread, stdin
+#include <stdexcept>    // std::runtime_error
+#include <string>       // std::string, std::string_literals
+#include <string_view>  // std::string_view
+#include <utility>      // std::exchange, std::move
+
+#if defined(_WIN32)
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#include <windows.h>  // CreateFileA, CreateFileMappingA, MapViewOfFile
+#else
+#include <fcntl.h>     // open
+#include <sys/mman.h>  // mmap, munmap, madvise
+#include <sys/stat.h>  // fstat
+#include <unistd.h>    // close, read
+#endif
+
+/**
+ * MappedFile exposes the whole content of a read-only file as a contiguous sequence of chars.
+ * Regular files are memory-mapped, so the OS pages them in on demand and no copy is made.
+ * The standard input and the other files that can't be mapped are read in bulk instead.
+ */
+class MappedFile {
+    const char* data = nullptr;
+    size_t length = 0;
+
+    // true if data points to a memory mapping, false if it points to buffer
+    bool is_mapped = false;
+
+    // fallback storage, used when the content can't be mapped
+    std::string buffer;
+
+#if defined(_WIN32)
+    HANDLE mapping = nullptr;
+#endif
+
+    MappedFile() = default;
+
+    // unmap the file, if it's mapped
+    void unmap() noexcept {
+        if (!is_mapped) {
+            return;
+        }
+
+#if defined(_WIN32)
+        UnmapViewOfFile(data);
+        CloseHandle(mapping);
+#else
+        munmap(const_cast<char*>(data), length);
+#endif
+    }
+
+public:
+    // Map the file with the given name. If it doesn't exist, std::runtime_error is thrown.
+    explicit MappedFile(const char* filename) {
+        using namespace std::string_literals;
+
+#if defined(_WIN32)
+        HANDLE file = CreateFileA(filename, GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+                                  FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+        if (file == INVALID_HANDLE_VALUE) {
+            throw std::runtime_error("File doesn't exist"s);
+        }
+
+        LARGE_INTEGER file_size;
+        GetFileSizeEx(file, &file_size);
+        length = static_cast<size_t>(file_size.QuadPart);
+
+        if (length > 0) {
+            mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+            data = mapping != nullptr
+                       ? static_cast<const char*>(MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0))
+                       : nullptr;
+            is_mapped = data != nullptr;
+        }
+        CloseHandle(file);
+#else
+        const int fd = open(filename, O_RDONLY);
+        if (fd == -1) {
+            throw std::runtime_error("File doesn't exist"s);
+        }
+
+        struct stat file_stat;
+        fstat(fd, &file_stat);
+        length = static_cast<size_t>(file_stat.st_size);
+
+        // pipes and devices (e.g. /dev/stdin) can't be mapped, they're read in bulk instead
+        if (!S_ISREG(file_stat.st_mode)) {
+            char chunk[1 << 16];
+            ssize_t n_read;
+
+            while ((n_read = ::read(fd, chunk, sizeof(chunk))) > 0) {
+                buffer.append(chunk, static_cast<size_t>(n_read));
+            }
+
+            data = buffer.data();
+            length = buffer.size();
+        } else if (length > 0) {
+            void* address = mmap(nullptr, length, PROT_READ, MAP_PRIVATE, fd, 0);
+            if (address != MAP_FAILED) {
+                madvise(address, length, MADV_SEQUENTIAL);
+                data = static_cast<const char*>(address);
+                is_mapped = true;
+            }
+        }
+        close(fd);
+#endif
+
+        if (length > 0 && data == nullptr) {
+            throw std::runtime_error("Unable to map file "s + filename);
+        }
+    }
+
+    // Read the whole standard input
+    [[nodiscard]] static MappedFile from_stdin() {
+        MappedFile file;
+        char chunk[1 << 16];
+        size_t n_read;
+
+        while ((n_read = std::fread(chunk, 1, sizeof(chunk), stdin)) > 0) {
+            file.buffer.append(chunk, n_read);
+        }
+
+        file.data = file.buffer.data();
+        file.length = file.buffer.size();
+        return file;
+    }
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    MappedFile(MappedFile&& other) noexcept :
+        data(std::exchange(other.data, nullptr)),
+        length(std::exchange(other.length, 0)),
+        is_mapped(std::exchange(other.is_mapped, false)),
+        buffer(std::move(other.buffer)) {
+#if defined(_WIN32)
+        mapping = std::exchange(other.mapping, nullptr);
+#endif
+        // short strings are copied rather than moved, so data must point to the new buffer
+        if (!is_mapped) {
+            data = buffer.data();
+        }
+    }
+
+    MappedFile& operator=(MappedFile&&) = delete;
+
+    ~MappedFile() {
+        unmap();
+    }
+
+    // Return the content of the file
+    [[nodiscard]] std::string_view view() const noexcept {
+        return std::string_view(data, length);
+    }
+};
@@ -1,10 +1,19 @@
 #pragma once
 
-#include <fstream>     // std::fstream
-#include <functional>  // std::bind
-#include <vector>      // std::vector
+#include <cstdint>  // int32_t, uint16_t
+#include <memory>   // std::shared_ptr
+#include <utility>  // std::move
+#include <vector>   // std::vector
 
+#include "../CoordinateDistances.h"
 #include "../DistanceMatrix.h"
+#include "../Distances.h"
+#include "../NeighborLists.h"
+#include "../hilbert_curve.h"
+#include "../spatial_utils/KDTree.h"
+#include "EdgeWeightType.h"
+#include "binary_instance.h"
+#include "metrics.h"
 #include "point.h"
 
 namespace point_reader {
@@ -13,52 +22,142 @@ namespace point_reader {
      */
     class PointReader {
     protected:
-        std::fstream& file;
+        // build the distance matrix of the points with the given layout. The last argument only
+        // selects the type of the distances. Each implementation fills the matrix with the distance
+        // functor of its metric, so that no virtual call is made per distance.
+        virtual DistanceMatrix<double> build_distance_matrix(DistanceMatrixLayout layout,
+                                                             double) const = 0;
+        virtual DistanceMatrix<int32_t> build_distance_matrix(DistanceMatrixLayout layout,
+                                                              int32_t) const = 0;
+        virtual DistanceMatrix<uint16_t> build_distance_matrix(DistanceMatrixLayout layout,
+                                                               uint16_t) const = 0;
 
-        // calculate the distance between the i-th and the j-th points
-        virtual double distance(size_t i, size_t j) const = 0;
+        // store the coordinates of the points in the structure of arrays x[] and y[]
+        virtual void get_coordinates(std::vector<double>& x, std::vector<double>& y) const = 0;
+
+        // renumber the points, so that the new i-th point is the old order[i]-th one
+        virtual void reorder(const std::vector<size_t>& order) = 0;
+
+        // original label of each point, if the points have been renumbered
+        std::vector<size_t> labels;
+
+        // binary instance the points were read from, if any. Its precomputed distance matrix and
+        // neighbor lists are used instead of computing them again.
+        std::shared_ptr<const binary_instance::MappedInstance> precomputed;
 
     public:
         const size_t dimension;
 
-        PointReader(std::fstream& file, size_t dimension) : file(file), dimension(dimension) {
+        explicit PointReader(size_t dimension) : dimension(dimension) {
         }
 
         virtual ~PointReader() = default;
 
-        // consume the list of points from the input file
-        virtual void read() = 0;
+        // return the metric of the distances between the points
+        [[nodiscard]] virtual EdgeWeightType edge_weight_type() const noexcept = 0;
 
-        // create a distance matrix after reading the points. It uses the distance method
-        // implemented by the child classes as an higher-order function
-        DistanceMatrix<double> create_distance_matrix() {
-            using namespace std::placeholders;
+        // renumber the points in the order they're visited by a Hilbert curve, so that near points
+        // get near labels and their distances are stored in near rows of the distance matrix.
+        // It must be called before creating the distances. EXPLICIT instances have no coordinates,
+        // so they keep their numbering.
+        void renumber_along_hilbert_curve() {
+            if (edge_weight_type() == EdgeWeightType::EXPLICIT) {
+                return;
+            }
 
-            // _1 and _2 indicate that the function receives 2 arguments.
-            auto distance_fun(std::bind(&PointReader::distance, this, _1, _2));
+            std::vector<double> x;
+            std::vector<double> y;
+            get_coordinates(x, y);
 
-            return DistanceMatrix<double>(dimension, distance_fun);
+            std::vector<size_t> order(hilbert_curve::sort(x, y));
+            reorder(order);
+            labels = std::move(order);
+
+            // the precomputed distances follow the original numbering
+            precomputed.reset();
+        }
+
+        // return the label that the i-th point had in the input file, before any renumbering
+        [[nodiscard]] size_t original_label(size_t i) const noexcept {
+            return labels.empty() ? i : labels[i];
+        }
+
+        // use the distance matrix and the neighbor lists stored in the given binary instance,
+        // whenever they match the requested ones
+        void set_precomputed(std::shared_ptr<const binary_instance::MappedInstance> instance) {
+            precomputed = std::move(instance);
+        }
+
+        // create a distance matrix after reading the points. layout selects how the matrix is
+        // stored in memory, T the type of its distances. If T is integral and a distance doesn't
+        // fit in it, std::overflow_error is thrown.
+        // If the points were read from a binary instance that stores a matching matrix, the
+        // returned matrix wraps its memory-mapped values instead.
+        template <typename T = double>
+        DistanceMatrix<T> create_distance_matrix(
+            DistanceMatrixLayout layout = DistanceMatrixLayout::FULL) const {
+            if (precomputed != nullptr && precomputed->has_distance_matrix<T>(layout)) {
+                return precomputed->distance_matrix<T>();
+            }
+
+            return build_distance_matrix(layout, T());
+        }
+
+        // create a distance oracle that computes the distances from the coordinates of the points
+        // on demand, without storing them. EXPLICIT instances have no coordinates, so
+        // std::runtime_error is thrown for them.
+        template <typename T = double>
+        CoordinateDistances<T> create_coordinate_distances() const {
+            std::vector<double> x;
+            std::vector<double> y;
+            get_coordinates(x, y);
+
+            return CoordinateDistances<T>(std::move(x), std::move(y), edge_weight_type());
         }
-    };
 
-    namespace detail {
-        /**
-         * Shared implementation of PointReader's read() method.
-         * This can't be directly embed it in PointReader because can't know a priori the the type
-         * associated with the vector point_vec. PointReader can't be generic either, because
-         * otherwise we wouldn't know how to instantiate it.
-         */
-        template <class Point>
-        void read_point(std::fstream& file, size_t dimension, std::vector<Point>& point_vec) {
-            size_t n;  // label of the vertex
-            Point p;   // generic point of the type required by the child class which called this
-                       // method
-            for (size_t i = 0; i < dimension; ++i) {
-                file >> n >> p;
-
-                // we decrease by 1 the value of the vertex for comfortableness reasons
-                point_vec.at(n - 1) = p;
+        // create the candidate lists of the k nearest neighbors of each point, according to the
+        // given distances. If the points were read from a binary instance that stores enough
+        // neighbors, they're loaded instead. If the metric ranks the points like the Euclidean
+        // distance, the lists are found with a k-d tree over the coordinates rather than by
+        // scanning every distance.
+        template <typename T>
+        NeighborLists create_neighbor_lists(const Distances<T>& distances, size_t k) const {
+            if (precomputed != nullptr && precomputed->has_neighbor_lists(k)) {
+                return precomputed->neighbor_lists(k);
             }
+
+            const EdgeWeightType metric = edge_weight_type();
+            const bool is_euclidean_order =
+                metric != EdgeWeightType::EXPLICIT &&
+                distance::visit_metric(metric, [](auto metric_distance) {
+                    return distance::is_euclidean_monotone<decltype(metric_distance)>();
+                });
+
+            if (is_euclidean_order) {
+                std::vector<double> x;
+                std::vector<double> y;
+                get_coordinates(x, y);
+
+                const spatial::KDTree tree(x, y);
+                return NeighborLists::from_spatial_index(dimension, tree, k);
+            }
+
+            return NeighborLists(distances, k);
+        }
+
+        // write the points, and optionally their distance matrix and neighbor lists, to a binary
+        // instance file. Both distance_matrix and neighbor_lists can be nullptr. Binary instances
+        // always store the coordinates, so EXPLICIT instances can't be written and
+        // std::runtime_error is thrown for them.
+        template <typename T>
+        void write_binary_instance(const char* filename, const DistanceMatrix<T>* distance_matrix,
+                                   const NeighborLists* neighbor_lists) const {
+            std::vector<double> x;
+            std::vector<double> y;
+            get_coordinates(x, y);
+
+            binary_instance::write(filename, edge_weight_type(), x, y, distance_matrix,
+                                   neighbor_lists);
         }
-    }  // namespace detail
+    };
 }  // namespace point_reader
@@ -0,0 +1,265 @@
+#pragma once
+
+#include <algorithm>    // std::min
+#include <cstdint>      // uint32_t, uint64_t
+#include <cstring>      // std::memcmp, std::memcpy
+#include <fstream>      // std::ofstream
+#include <limits>       // std::numeric_limits
+#include <memory>       // std::shared_ptr
+#include <stdexcept>    // std::runtime_error
+#include <string>       // std::string, std::string_literals
+#include <string_view>  // std::string_view
+#include <utility>      // std::move
+#include <vector>       // std::vector
+
+#include "../DistanceMatrix.h"
+#include "../DistanceType.h"
+#include "../NeighborLists.h"
+#include "EdgeWeightType.h"
+#include "MappedFile.h"
+
+namespace binary_instance {
+    // first bytes of every binary instance file
+    constexpr char MAGIC[8] = {'T', 'S', 'P', 'B', 'I', 'N', '\r', '\n'};
+
+    // incremented whenever the layout of the file changes
+    constexpr uint32_t VERSION = 1;
+
+    // every section starts at a multiple of ALIGNMENT bytes from the beginning of the file
+    constexpr uint64_t ALIGNMENT = 64;
+
+    /**
+     * Header at the beginning of a binary instance file. The sections that follow it are stored
+     * in the byte order of the machine that wrote the file:
+     * - coordinates: dimension doubles x[], followed by dimension doubles y[];
+     * - distance matrix (optional): the raw values of a DistanceMatrix<T> with the given layout,
+     *   where T is identified by distance_type;
+     * - neighbor lists (optional): neighbors_k uint32_t vertexes per vertex, nearest first.
+     */
+    struct Header {
+        char magic[8];
+        uint32_t version;
+        uint32_t edge_weight_type;
+        uint64_t dimension;
+        uint64_t coordinates_offset;
+        uint64_t matrix_offset;  // 0 if there's no distance matrix
+        uint32_t distance_type;
+        uint32_t distance_layout;
+        uint64_t neighbors_offset;  // 0 if there are no neighbor lists
+        uint64_t neighbors_k;
+    };
+
+    namespace detail {
+        // Round offset up to the next multiple of ALIGNMENT
+        [[nodiscard]] constexpr uint64_t align(uint64_t offset) noexcept {
+            return (offset + ALIGNMENT - 1) / ALIGNMENT * ALIGNMENT;
+        }
+
+        [[noreturn]] inline void throw_format_error() {
+            using namespace std::string_literals;
+            throw std::runtime_error("Malformed binary instance file"s);
+        }
+
+        // Return a * b, throwing if the product of these sizes read from a file overflows
+        [[nodiscard]] inline uint64_t multiply(uint64_t a, uint64_t b) {
+            if (a != 0 && b > std::numeric_limits<uint64_t>::max() / a) {
+                throw_format_error();
+            }
+
+            return a * b;
+        }
+    }  // namespace detail
+
+    // Return true if content starts like a binary instance file
+    [[nodiscard]] inline bool is_binary_instance(std::string_view content) noexcept {
+        return content.size() >= sizeof(MAGIC) &&
+               std::memcmp(content.data(), MAGIC, sizeof(MAGIC)) == 0;
+    }
+
+    /**
+     * MappedInstance is a read-only view over a binary instance file mapped in memory.
+     * Its distance matrix wraps the mapped pages rather than copying them, so processes that map
+     * the same file share a single copy of the matrix in the OS page cache.
+     */
+    class MappedInstance {
+        std::shared_ptr<const MappedFile> file;
+        const Header* header;
+
+        // Return the section that starts at the given offset
+        template <typename Value>
+        [[nodiscard]] const Value* section(uint64_t offset) const noexcept {
+            return reinterpret_cast<const Value*>(file->view().data() + offset);
+        }
+
+        // Throw if the section of size bytes at the given offset isn't entirely in the file
+        void check_section(uint64_t offset, uint64_t size) const {
+            const uint64_t file_size = file->view().size();
+
+            if (offset % ALIGNMENT != 0 || offset > file_size || size > file_size - offset) {
+                detail::throw_format_error();
+            }
+        }
+
+    public:
+        explicit MappedInstance(std::shared_ptr<const MappedFile> mapped_file) :
+            file(std::move(mapped_file)), header(section<Header>(0)) {
+            if (!is_binary_instance(file->view()) || file->view().size() < sizeof(Header) ||
+                header->version != VERSION) {
+                detail::throw_format_error();
+            }
+
+            // the enumerations are read from the file, so they may hold any value. EXPLICIT
+            // instances have no coordinates, so they're never written as binary instances.
+            if (header->edge_weight_type >= static_cast<uint32_t>(EdgeWeightType::EXPLICIT) ||
+                header->distance_type > static_cast<uint32_t>(DistanceType::UINT16) ||
+                header->distance_layout > static_cast<uint32_t>(DistanceMatrixLayout::PACKED)) {
+                detail::throw_format_error();
+            }
+
+            // every vertex takes 2 doubles in the file, so a larger dimension can't be valid.
+            // Bounding it first keeps the sizes of the sections from overflowing.
+            const uint64_t n = header->dimension;
+            if (n > file->view().size() / (2 * sizeof(double))) {
+                detail::throw_format_error();
+            }
+
+            check_section(header->coordinates_offset, 2 * n * sizeof(double));
+
+            if (header->matrix_offset != 0) {
+                const auto layout = static_cast<DistanceMatrixLayout>(header->distance_layout);
+                const uint64_t n_values = layout == DistanceMatrixLayout::PACKED
+                                              ? detail::multiply(n, n + 1) / 2
+                                              : detail::multiply(n, n);
+                const uint64_t value_size = visit_distance_type(
+                    static_cast<DistanceType>(header->distance_type),
+                    [](auto distance) { return sizeof(distance); });
+                check_section(header->matrix_offset, detail::multiply(n_values, value_size));
+            }
+
+            if (header->neighbors_offset != 0) {
+                const uint64_t n_neighbors = detail::multiply(n, header->neighbors_k);
+                check_section(header->neighbors_offset,
+                              detail::multiply(n_neighbors, sizeof(uint32_t)));
+            }
+        }
+
+        // Return the number of vertexes
+        [[nodiscard]] size_t dimension() const noexcept {
+            return header->dimension;
+        }
+
+        [[nodiscard]] EdgeWeightType edge_weight_type() const noexcept {
+            return static_cast<EdgeWeightType>(header->edge_weight_type);
+        }
+
+        // Copy the coordinates of the points in the structure of arrays x[] and y[]
+        void get_coordinates(std::vector<double>& x, std::vector<double>& y) const {
+            const double* coordinates = section<double>(header->coordinates_offset);
+            x.assign(coordinates, coordinates + dimension());
+            y.assign(coordinates + dimension(), coordinates + 2 * dimension());
+        }
+
+        // Return true if the file stores a distance matrix of type T with the given layout
+        template <typename T>
+        [[nodiscard]] bool has_distance_matrix(DistanceMatrixLayout layout) const noexcept {
+            return header->matrix_offset != 0 &&
+                   header->distance_type == static_cast<uint32_t>(distance_type_of<T>()) &&
+                   header->distance_layout == static_cast<uint32_t>(layout);
+        }
+
+        // Return the stored distance matrix, which wraps the mapped pages.
+        // Precondition: has_distance_matrix<T>(layout) is true for some layout.
+        template <typename T>
+        [[nodiscard]] DistanceMatrix<T> distance_matrix() const {
+            const auto layout = static_cast<DistanceMatrixLayout>(header->distance_layout);
+            return DistanceMatrix<T>(dimension(), layout, section<T>(header->matrix_offset), file);
+        }
+
+        // Return true if the file stores at least k neighbors per vertex, k clipped to
+        // dimension() - 1
+        [[nodiscard]] bool has_neighbor_lists(size_t k) const noexcept {
+            const size_t max_k = dimension() > 0 ? dimension() - 1 : 0;
+            return header->neighbors_offset != 0 && header->neighbors_k >= std::min(k, max_k);
+        }
+
+        // Return the candidate lists of the k nearest neighbors of each vertex.
+        // Precondition: has_neighbor_lists(k) is true.
+        [[nodiscard]] NeighborLists neighbor_lists(size_t k) const {
+            return NeighborLists::from_rows(dimension(), header->neighbors_k, k,
+                                            section<uint32_t>(header->neighbors_offset));
+        }
+    };
+
+    namespace detail {
+        // Write size bytes of data to file, after padding the file with 0s up to offset
+        inline void write_section(std::ofstream& file, uint64_t offset, const void* data,
+                                  uint64_t size) {
+            const auto position = static_cast<uint64_t>(file.tellp());
+            const std::vector<char> padding(offset - position, '\0');
+            file.write(padding.data(), padding.size());
+            file.write(static_cast<const char*>(data), size);
+        }
+    }  // namespace detail
+
+    // Write a binary instance file with the given points and, optionally, a distance matrix and
+    // candidate lists. Both distance_matrix and neighbor_lists can be nullptr.
+    template <typename T>
+    void write(const char* filename, EdgeWeightType edge_weight_type, const std::vector<double>& x,
+               const std::vector<double>& y, const DistanceMatrix<T>* distance_matrix,
+               const NeighborLists* neighbor_lists) {
+        using namespace std::string_literals;
+
+        const uint64_t n = x.size();
+
+        Header header{};
+        std::memcpy(header.magic, MAGIC, sizeof(MAGIC));
+        header.version = VERSION;
+        header.edge_weight_type = static_cast<uint32_t>(edge_weight_type);
+        header.dimension = n;
+        header.coordinates_offset = detail::align(sizeof(Header));
+        uint64_t end = header.coordinates_offset + 2 * n * sizeof(double);
+
+        if (distance_matrix != nullptr) {
+            header.matrix_offset = detail::align(end);
+            header.distance_type = static_cast<uint32_t>(distance_type_of<T>());
+            header.distance_layout = static_cast<uint32_t>(distance_matrix->get_layout());
+            end = header.matrix_offset + distance_matrix->raw_size() * sizeof(T);
+        }
+
+        // the neighbors are narrowed to 32 bits to halve the size of the section
+        std::vector<uint32_t> neighbors;
+        if (neighbor_lists != nullptr) {
+            header.neighbors_offset = detail::align(end);
+            header.neighbors_k = neighbor_lists->neighbors_per_vertex();
+            neighbors.reserve(n * header.neighbors_k);
+
+            for (size_t i = 0; i < n; ++i) {
+                neighbors.insert(neighbors.end(), neighbor_lists->begin(i),
+                                 neighbor_lists->end(i));
+            }
+        }
+
+        std::ofstream file(filename, std::ios::binary | std::ios::trunc);
+        if (!file.good()) {
+            throw std::runtime_error("Unable to create file "s + filename);
+        }
+
+        detail::write_section(file, 0, &header, sizeof(Header));
+        detail::write_section(file, header.coordinates_offset, x.data(), n * sizeof(double));
+        file.write(reinterpret_cast<const char*>(y.data()), n * sizeof(double));
+
+        if (distance_matrix != nullptr) {
+            detail::write_section(file, header.matrix_offset, distance_matrix->raw_data(),
+                                  distance_matrix->raw_size() * sizeof(T));
+        }
+
+        if (neighbor_lists != nullptr) {
+            detail::write_section(file, header.neighbors_offset, neighbors.data(),
+                                  neighbors.size() * sizeof(uint32_t));
+        }
+
+        if (!file.good()) {
+            throw std::runtime_error("Unable to write file "s + filename);
+        }
+    }
+}  // namespace binary_instance
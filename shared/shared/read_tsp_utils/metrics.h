@@ -0,0 +1,138 @@
+#pragma once
+
+#include <cmath>        // std::sqrt, std::abs, std::ceil, std::trunc, std::cos, std::acos
+#include <type_traits>  // std::is_same_v
+
+#include "EdgeWeightType.h"
+
+/**
+ * Distance functors of the TSPLIB metrics defined on 2D coordinates. Each functor computes the
+ * integral distance between (x_i, y_i) and (x_j, y_j) as a double, according to the TSPLIB95
+ * specification.
+ * They're selected at compile time with visit_metric, so that the loops that compute many
+ * distances with the same metric are fully inlined.
+ */
+namespace distance {
+    namespace detail {
+        // Round a non-negative value to the nearest integer, with halfway cases rounded up.
+        // Truncating d + (0.5 - ε) is equivalent to std::round(d) for d >= 0, and it's the only
+        // rounding available in SSE2.
+        constexpr double ROUNDING_OFFSET = 0.49999999999999994;
+
+        [[nodiscard]] inline double nint(double value) noexcept {
+            return std::trunc(value + ROUNDING_OFFSET);
+        }
+
+        // Convert a coordinate in the DDD.MM format (degrees and minutes) to radians
+        [[nodiscard]] inline double to_radians(double coordinate) noexcept {
+            constexpr double PI = 3.141592;
+            const double degrees = std::trunc(coordinate);
+            const double minutes = coordinate - degrees;
+            return PI * (degrees + 5.0 * minutes / 3.0) / 180.0;
+        }
+    }  // namespace detail
+
+    // Euclidean distance rounded to the nearest integer (EUC_2D)
+    struct Euclidean2D {
+        [[nodiscard]] double operator()(double x_i, double y_i, double x_j,
+                                        double y_j) const noexcept {
+            const double dx = x_i - x_j;
+            const double dy = y_i - y_j;
+            return detail::nint(std::sqrt(dx * dx + dy * dy));
+        }
+    };
+
+    // Euclidean distance rounded up to the next integer (CEIL_2D)
+    struct Ceil2D {
+        [[nodiscard]] double operator()(double x_i, double y_i, double x_j,
+                                        double y_j) const noexcept {
+            const double dx = x_i - x_j;
+            const double dy = y_i - y_j;
+            return std::ceil(std::sqrt(dx * dx + dy * dy));
+        }
+    };
+
+    // Pseudo-Euclidean distance of the att48 and att532 instances (ATT)
+    struct Att {
+        [[nodiscard]] double operator()(double x_i, double y_i, double x_j,
+                                        double y_j) const noexcept {
+            const double dx = x_i - x_j;
+            const double dy = y_i - y_j;
+            const double r = std::sqrt((dx * dx + dy * dy) / 10.0);
+            const double t = detail::nint(r);
+            return t < r ? t + 1.0 : t;
+        }
+    };
+
+    // Manhattan distance rounded to the nearest integer (MAN_2D)
+    struct Manhattan2D {
+        [[nodiscard]] double operator()(double x_i, double y_i, double x_j,
+                                        double y_j) const noexcept {
+            return detail::nint(std::abs(x_i - x_j) + std::abs(y_i - y_j));
+        }
+    };
+
+    // Geographical distance in km (GEO). x is the latitude and y the longitude, both in the
+    // DDD.MM format.
+    struct Geo {
+        // radius of the idealized Earth sphere, in km
+        static constexpr double RRR = 6378.388;
+
+        [[nodiscard]] double operator()(double x_i, double y_i, double x_j,
+                                        double y_j) const noexcept {
+            // the formula yields 1 for a point and itself, which must be 0 like the main
+            // diagonal of the distance matrix
+            if (x_i == x_j && y_i == y_j) {
+                return 0.0;
+            }
+
+            const double latitude_i = detail::to_radians(x_i);
+            const double longitude_i = detail::to_radians(y_i);
+            const double latitude_j = detail::to_radians(x_j);
+            const double longitude_j = detail::to_radians(y_j);
+
+            const double q1 = std::cos(longitude_i - longitude_j);
+            const double q2 = std::cos(latitude_i - latitude_j);
+            const double q3 = std::cos(latitude_i + latitude_j);
+            return std::trunc(RRR * std::acos(0.5 * ((1.0 + q1) * q2 - (1.0 - q1) * q3)) + 1.0);
+        }
+    };
+
+    // Return true if the metric is a non-decreasing function of the Euclidean distance, so that
+    // the two farthest points are vertexes of the convex hull
+    template <class Metric>
+    constexpr bool is_euclidean_monotone() noexcept {
+        return !std::is_same_v<Metric, Manhattan2D> && !std::is_same_v<Metric, Geo>;
+    }
+
+    // Return an upper bound of the distance between any two points in a bounding box of the
+    // given width and height
+    template <class Metric>
+    [[nodiscard]] double max_distance(Metric distance, double width, double height) noexcept {
+        if constexpr (std::is_same_v<Metric, Geo>) {
+            // half of the circumference of the Earth
+            return std::trunc(Geo::RRR * std::acos(-1.0) + 1.0);
+        } else {
+            // the other metrics don't decrease when |x_i - x_j| or |y_i - y_j| increase
+            return distance(0.0, 0.0, width, height);
+        }
+    }
+
+    // Call the generic function f with the distance functor of the given metric defined on
+    // coordinates. EXPLICIT has no such functor, and it's treated as EUC_2D.
+    template <class Function>
+    decltype(auto) visit_metric(EdgeWeightType edge_weight_type, Function&& f) {
+        switch (edge_weight_type) {
+        case EdgeWeightType::CEIL_2D:
+            return f(Ceil2D());
+        case EdgeWeightType::ATT:
+            return f(Att());
+        case EdgeWeightType::MAN_2D:
+            return f(Manhattan2D());
+        case EdgeWeightType::GEO:
+            return f(Geo());
+        default:
+            return f(Euclidean2D());
+        }
+    }
+}  // namespace distance
@@ -1,24 +1,25 @@
 #pragma once
 
-// suppress warning C4715: not all control paths return a value
-#if defined(_MSC_VER)
-#pragma warning(disable : 4715)
-#endif
-
-#include <fstream>  // std::fstream
+#include <memory>   // std::unique_ptr, std::make_unique
+#include <utility>  // std::move
 
+#include "CoordinatePointReader.h"
 #include "EdgeWeightType.h"
-#include "EuclideanPointReader.h"
+#include "ExplicitPointReader.h"
 #include "PointReader.h"
+#include "tsplib_parser.h"
 
 namespace point_reader {
-    // Only Euclidean distance is allowed.
-    std::unique_ptr<PointReader> point_reader_factory(EdgeWeightType edge_weight_type,
-                                                      std::fstream& file,
-                                                      size_t dimension) noexcept {
-        switch (edge_weight_type) {
-        case EdgeWeightType::EUC_2D:
-            return std::make_unique<EuclideanPointReader>(file, dimension);
+    // Create the point reader of the given instance. The metric of its distances is selected here,
+    // once: EXPLICIT instances store their distances, the other metrics compute them from the
+    // coordinates of the points.
+    inline std::unique_ptr<PointReader> point_reader_factory(tsplib::Instance instance) {
+        if (instance.edge_weight_type == EdgeWeightType::EXPLICIT) {
+            return std::make_unique<ExplicitPointReader>(instance.dimension,
+                                                         std::move(instance.weights));
         }
+
+        return std::make_unique<CoordinatePointReader>(
+            instance.edge_weight_type, std::move(instance.x), std::move(instance.y));
     }
 }  // namespace point_reader
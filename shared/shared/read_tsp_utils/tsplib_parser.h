@@ -0,0 +1,207 @@
+#pragma once
+
+#include <charconv>      // std::from_chars
+#include <stdexcept>     // std::runtime_error
+#include <string>        // std::string, std::string_literals
+#include <string_view>   // std::string_view
+#include <system_error>  // std::errc
+#include <vector>        // std::vector
+
+#include "EdgeWeightType.h"
+
+namespace tsplib {
+    // TSP instance with 2D coordinates, stored as a structure of arrays: the i-th point is
+    // (x[i], y[i]), and its label in the file is i + 1.
+    // EXPLICIT instances have no coordinates: the distance between i and j > i is stored in
+    // weights[i * dimension - i * (i + 1) / 2 + j - i - 1] instead.
+    struct Instance {
+        std::string name;
+        size_t dimension = 0;
+        EdgeWeightType edge_weight_type = EdgeWeightType::EUC_2D;
+        EdgeWeightFormat edge_weight_format = EdgeWeightFormat::FULL_MATRIX;
+        std::vector<double> x;
+        std::vector<double> y;
+        std::vector<double> weights;
+    };
+
+    namespace detail {
+        [[nodiscard]] inline bool is_space(char c) noexcept {
+            return c == ' ' || c == '\t' || c == '\r' || c == '\n';
+        }
+
+        // Remove the leading and trailing whitespaces
+        [[nodiscard]] inline std::string_view trim(std::string_view text) noexcept {
+            while (!text.empty() && is_space(text.front())) {
+                text.remove_prefix(1);
+            }
+            while (!text.empty() && is_space(text.back())) {
+                text.remove_suffix(1);
+            }
+            return text;
+        }
+
+        [[noreturn]] inline void throw_parse_error(std::string_view what) {
+            using namespace std::string_literals;
+            throw std::runtime_error("Malformed TSP file: "s + std::string(what));
+        }
+
+        /**
+         * Cursor over the content of a TSPLIB file, which is consumed line by line in the header
+         * and token by token in the data sections.
+         */
+        class Reader {
+            const char* it;
+            const char* end;
+
+        public:
+            explicit Reader(std::string_view text) noexcept :
+                it(text.data()), end(text.data() + text.size()) {
+            }
+
+            [[nodiscard]] bool is_done() const noexcept {
+                return it == end;
+            }
+
+            // Consume the next line, without its line terminator
+            [[nodiscard]] std::string_view next_line() noexcept {
+                const char* line_begin = it;
+                while (it != end && *it != '\n') {
+                    ++it;
+                }
+
+                std::string_view line(line_begin, it - line_begin);
+                if (it != end) {
+                    ++it;
+                }
+                return line;
+            }
+
+            // Consume the next number, skipping the whitespaces that precede it
+            template <typename Number>
+            [[nodiscard]] Number next_number() {
+                while (it != end && is_space(*it)) {
+                    ++it;
+                }
+
+                Number number;
+                const auto [next, error] = std::from_chars(it, end, number);
+                if (error != std::errc()) {
+                    throw_parse_error("expected a number");
+                }
+
+                it = next;
+                return number;
+            }
+        };
+
+        // Read the NODE_COORD_SECTION. Each line contains the label of a point, in [1, dimension],
+        // and its coordinates.
+        inline void read_node_coord_section(Reader& reader, Instance& instance) {
+            instance.x.resize(instance.dimension);
+            instance.y.resize(instance.dimension);
+
+            for (size_t i = 0; i < instance.dimension; ++i) {
+                const auto label = reader.next_number<size_t>();
+                if (label == 0 || label > instance.dimension) {
+                    throw_parse_error("node label out of range");
+                }
+
+                // we decrease by 1 the value of the vertex for comfortableness reasons
+                instance.x[label - 1] = reader.next_number<double>();
+                instance.y[label - 1] = reader.next_number<double>();
+            }
+        }
+
+        // Read the EDGE_WEIGHT_SECTION according to the EDGE_WEIGHT_FORMAT. Only the distances
+        // above the main diagonal are kept, since the instance is symmetric.
+        inline void read_edge_weight_section(Reader& reader, Instance& instance) {
+            const size_t n = instance.dimension;
+            instance.weights.reserve(n > 0 ? n * (n - 1) / 2 : 0);
+
+            for (size_t i = 0; i < n; ++i) {
+                if (instance.edge_weight_format == EdgeWeightFormat::FULL_MATRIX) {
+                    // skip the main diagonal and the triangle below it
+                    for (size_t j = 0; j <= i; ++j) {
+                        static_cast<void>(reader.next_number<double>());
+                    }
+                }
+
+                for (size_t j = i + 1; j < n; ++j) {
+                    instance.weights.push_back(reader.next_number<double>());
+                }
+            }
+        }
+    }  // namespace detail
+
+    // Parse the content of a TSPLIB file. The keywords of the header can appear in any order,
+    // and the unknown ones are ignored.
+    [[nodiscard]] inline Instance parse(std::string_view text) {
+        Instance instance;
+        bool has_dimension = false;
+        bool has_edge_weight_type = false;
+        bool has_edge_weight_format = false;
+
+        detail::Reader reader(text);
+        while (!reader.is_done()) {
+            const std::string_view line = detail::trim(reader.next_line());
+
+            if (line.empty()) {
+                continue;
+            }
+
+            // header lines have the form "KEYWORD : value", section lines only have the keyword
+            const size_t colon = line.find(':');
+            const std::string_view keyword = detail::trim(line.substr(0, colon));
+            const std::string_view value =
+                colon == std::string_view::npos ? std::string_view()
+                                                : detail::trim(line.substr(colon + 1));
+
+            if (keyword == "EOF") {
+                break;
+            }
+
+            if (keyword == "NODE_COORD_SECTION") {
+                if (!has_dimension || !has_edge_weight_type) {
+                    detail::throw_parse_error("DIMENSION or EDGE_WEIGHT_TYPE is missing");
+                }
+
+                detail::read_node_coord_section(reader, instance);
+
+                // the coordinates of EXPLICIT instances are only used for display purposes
+                if (instance.edge_weight_type != EdgeWeightType::EXPLICIT) {
+                    return instance;
+                }
+                continue;
+            }
+
+            if (keyword == "EDGE_WEIGHT_SECTION") {
+                if (!has_dimension || instance.edge_weight_type != EdgeWeightType::EXPLICIT ||
+                    !has_edge_weight_format) {
+                    detail::throw_parse_error(
+                        "DIMENSION, EDGE_WEIGHT_TYPE or EDGE_WEIGHT_FORMAT is missing");
+                }
+
+                detail::read_edge_weight_section(reader, instance);
+                return instance;
+            }
+
+            if (keyword == "NAME") {
+                instance.name = value;
+            } else if (keyword == "DIMENSION") {
+                detail::Reader value_reader(value);
+                instance.dimension = value_reader.next_number<size_t>();
+                has_dimension = true;
+            } else if (keyword == "EDGE_WEIGHT_TYPE") {
+                instance.edge_weight_type = parse_edge_weight_type(value);
+                has_edge_weight_type = true;
+            } else if (keyword == "EDGE_WEIGHT_FORMAT") {
+                instance.edge_weight_format = parse_edge_weight_format(value);
+                has_edge_weight_format = true;
+            }
+        }
+
+        detail::throw_parse_error(instance.edge_weight_type == EdgeWeightType::EXPLICIT
+                                      ? "EDGE_WEIGHT_SECTION is missing"
+                                      : "NODE_COORD_SECTION is missing");
+    }
+}  // namespace tsplib
@@ -0,0 +1,209 @@
+#pragma once
+
+#include <algorithm>  // std::minmax_element, std::max, std::min, std::swap
+#include <cmath>      // std::sqrt, std::floor
+#include <cstddef>    // ptrdiff_t
+#include <vector>     // std::vector
+
+#include "../read_tsp_utils/point.h"
+#include "utils.h"
+
+namespace spatial {
+    /**
+     * BucketGrid partitions the bounding box of a set of points into square cells of about
+     * POINTS_PER_CELL points each. On points spread uniformly, the k-nearest, fixed-radius and
+     * nearest-point queries of utils.h scan the rings of cells around the query, in O(1)
+     * expected time per reported point. Points can be removed, e.g. once a construction
+     * heuristic has visited them, and the queries ignore them.
+     * The points of each cell are stored contiguously, the active ones first. Empty cells are
+     * still scanned, so KDTree is faster once most of the points have been removed.
+     */
+    class BucketGrid {
+        // average number of points per cell
+        static constexpr double POINTS_PER_CELL = 2.0;
+
+        std::vector<point::point_2D> points;
+
+        double x_min = 0.0;
+        double y_min = 0.0;
+        double cell_side = 1.0;
+        size_t n_columns = 1;
+        size_t n_rows = 1;
+
+        // the points of the c-th cell are items[cell_begin[c], cell_begin[c + 1]), and the first
+        // cell_active[c] of them haven't been removed
+        std::vector<size_t> cell_begin;
+        std::vector<size_t> cell_active;
+        std::vector<size_t> items;
+
+        // cell[i] is the cell of the i-th point, position[i] its position in items
+        std::vector<size_t> cell;
+        std::vector<size_t> position;
+
+        size_t n_active = 0;
+
+        // Return the column or row of the given coordinate, clipped to [0, n)
+        [[nodiscard]] size_t index_of(double coordinate, double min, size_t n) const noexcept {
+            const double index = std::floor((coordinate - min) / cell_side);
+            return index <= 0 ? 0 : std::min(static_cast<size_t>(index), n - 1);
+        }
+
+        // Visit the active points of the cell (column, row), except exclude
+        template <typename Visit>
+        void visit_cell(size_t column, size_t row, const point::point_2D& query, size_t exclude,
+                        Visit& visit) const {
+            const size_t c = row * n_columns + column;
+            const size_t begin = cell_begin[c];
+
+            for (size_t p = begin; p < begin + cell_active[c]; ++p) {
+                const size_t i = items[p];
+                if (i != exclude) {
+                    visit(candidate_t(squared_distance(query, points[i]), i));
+                }
+            }
+        }
+
+        // Visit the active points of the cells at Chebyshev distance r from the cell
+        // (column, row), i.e. the r-th ring of cells around it
+        template <typename Visit>
+        void visit_ring(size_t column, size_t row, size_t r, const point::point_2D& query,
+                        size_t exclude, Visit& visit) const {
+            const auto c = static_cast<ptrdiff_t>(column);
+            const auto w = static_cast<ptrdiff_t>(row);
+            const auto d = static_cast<ptrdiff_t>(r);
+
+            for (ptrdiff_t y = w - d; y <= w + d; ++y) {
+                if (y < 0 || y >= static_cast<ptrdiff_t>(n_rows)) {
+                    continue;
+                }
+
+                // only the first and last rows of the ring are full
+                const bool is_full_row = y == w - d || y == w + d;
+                const ptrdiff_t step = is_full_row ? 1 : std::max<ptrdiff_t>(1, 2 * d);
+                for (ptrdiff_t x = c - d; x <= c + d; x += step) {
+                    if (x >= 0 && x < static_cast<ptrdiff_t>(n_columns)) {
+                        visit_cell(x, y, query, exclude, visit);
+                    }
+                }
+            }
+        }
+
+        // Return the distance from query to the nearest cell outside the (2r + 1)×(2r + 1)
+        // square of cells centered in (column, row)
+        [[nodiscard]] double ring_distance(size_t column, size_t row, size_t r,
+                                           const point::point_2D& query) const noexcept {
+            const double c = static_cast<double>(column);
+            const double w = static_cast<double>(row);
+            const double d = static_cast<double>(r);
+
+            const double left = query.x - (x_min + (c - d) * cell_side);
+            const double right = x_min + (c + d + 1) * cell_side - query.x;
+            const double bottom = query.y - (y_min + (w - d) * cell_side);
+            const double top = y_min + (w + d + 1) * cell_side - query.y;
+            return std::max(0.0, std::min(std::min(left, right), std::min(bottom, top)));
+        }
+
+    public:
+        // Build the grid of the points (x[i], y[i]) in O(n)
+        BucketGrid(const std::vector<double>& x, const std::vector<double>& y) :
+            points(x.size()), cell(x.size()), position(x.size()), n_active(x.size()) {
+            for (size_t i = 0; i < points.size(); ++i) {
+                points[i] = point::point_2D(x[i], y[i]);
+            }
+
+            if (!points.empty()) {
+                const auto [x_lo, x_hi] = std::minmax_element(x.cbegin(), x.cend());
+                const auto [y_lo, y_hi] = std::minmax_element(y.cbegin(), y.cend());
+                const double width = *x_hi - *x_lo;
+                const double height = *y_hi - *y_lo;
+                const double n_cells = std::max(1.0, points.size() / POINTS_PER_CELL);
+
+                x_min = *x_lo;
+                y_min = *y_lo;
+
+                // degenerate boxes (a single point or collinear points) are split along their
+                // longest side only
+                const double area = width * height;
+                cell_side =
+                    area > 0 ? std::sqrt(area / n_cells) : std::max(width, height) / n_cells;
+                if (!(cell_side > 0)) {
+                    cell_side = 1.0;
+                }
+
+                n_columns = static_cast<size_t>(width / cell_side) + 1;
+                n_rows = static_cast<size_t>(height / cell_side) + 1;
+            }
+
+            // counting sort of the points by cell
+            cell_begin.assign(n_columns * n_rows + 1, 0);
+            for (size_t i = 0; i < points.size(); ++i) {
+                cell[i] = index_of(points[i].y, y_min, n_rows) * n_columns +
+                          index_of(points[i].x, x_min, n_columns);
+                ++cell_begin[cell[i] + 1];
+            }
+
+            for (size_t c = 0; c + 1 < cell_begin.size(); ++c) {
+                cell_begin[c + 1] += cell_begin[c];
+            }
+
+            cell_active.assign(n_columns * n_rows, 0);
+            items.resize(points.size());
+            for (size_t i = 0; i < points.size(); ++i) {
+                position[i] = cell_begin[cell[i]] + cell_active[cell[i]]++;
+                items[position[i]] = i;
+            }
+        }
+
+        // Return the number of points that haven't been removed
+        [[nodiscard]] size_t size() const noexcept {
+            return n_active;
+        }
+
+        // Return the i-th point
+        [[nodiscard]] const point::point_2D& point_at(size_t i) const noexcept {
+            return points[i];
+        }
+
+        // Return true if the i-th point hasn't been removed
+        [[nodiscard]] bool contains(size_t i) const noexcept {
+            return position[i] < cell_begin[cell[i]] + cell_active[cell[i]];
+        }
+
+        // Remove the i-th point from the following queries, in O(1)
+        void remove(size_t i) {
+            if (!contains(i)) {
+                return;
+            }
+
+            // swap the point with the last active point of its cell
+            const size_t c = cell[i];
+            const size_t last = cell_begin[c] + --cell_active[c];
+            const size_t j = items[last];
+
+            std::swap(items[position[i]], items[last]);
+            position[j] = position[i];
+            position[i] = last;
+            --n_active;
+        }
+
+        // Visit the active points, except exclude, in the rings of cells around query, from the
+        // nearest one, until every point nearer than bound() has been visited. visit(candidate) is
+        // called for each of them.
+        template <typename Bound, typename Visit>
+        void search(const point::point_2D& query, size_t exclude, const Bound& bound,
+                    Visit& visit) const {
+            const size_t column = index_of(query.x, x_min, n_columns);
+            const size_t row = index_of(query.y, y_min, n_rows);
+            const size_t max_r = std::max(n_columns, n_rows);
+
+            for (size_t r = 0; r < max_r; ++r) {
+                visit_ring(column, row, r, query, exclude, visit);
+
+                const double distance = ring_distance(column, row, r, query);
+                if (distance * distance > bound()) {
+                    return;
+                }
+            }
+        }
+    };
+}  // namespace spatial
@@ -0,0 +1,183 @@
+#pragma once
+
+#include <algorithm>  // std::nth_element, std::minmax_element
+#include <cstdint>    // uint8_t
+#include <numeric>    // std::iota
+#include <vector>     // std::vector
+
+#include "../read_tsp_utils/point.h"
+#include "utils.h"
+
+namespace spatial {
+    /**
+     * KDTree is a balanced 2-d tree over a set of points, on which the k-nearest, fixed-radius
+     * and nearest-point queries of utils.h take O(log n) expected time per reported point.
+     * Points can be removed, e.g. once a construction heuristic has visited them, and the queries
+     * ignore them.
+     * The tree is stored implicitly in a permutation of the points: the node of the range
+     * [lo, hi) is the point at (lo + hi) / 2, its left subtree is [lo, (lo + hi) / 2) and its
+     * right subtree is ((lo + hi) / 2, hi).
+     */
+    class KDTree {
+        std::vector<point::point_2D> points;
+
+        // points in tree order
+        std::vector<size_t> order;
+
+        // position[i] is the position of the i-th point in order
+        std::vector<size_t> position;
+
+        // split_axis[m] is the axis (0 for x, 1 for y) that splits the node at position m
+        std::vector<uint8_t> split_axis;
+
+        // n_active[m] is the number of points still in the subtree rooted at position m
+        std::vector<size_t> n_active;
+
+        // is_active[i] is true if the i-th point hasn't been removed
+        std::vector<bool> is_active;
+
+        [[nodiscard]] static double coordinate(const point::point_2D& point,
+                                               uint8_t axis) noexcept {
+            return axis == 0 ? point.x : point.y;
+        }
+
+        // Build the subtree of the range [lo, hi), splitting it along its widest axis
+        void build(size_t lo, size_t hi) {
+            if (lo >= hi) {
+                return;
+            }
+
+            const auto [x_min, x_max] = std::minmax_element(
+                order.begin() + lo, order.begin() + hi,
+                [this](size_t a, size_t b) { return points[a].x < points[b].x; });
+            const auto [y_min, y_max] = std::minmax_element(
+                order.begin() + lo, order.begin() + hi,
+                [this](size_t a, size_t b) { return points[a].y < points[b].y; });
+            const uint8_t axis = points[*x_max].x - points[*x_min].x >=
+                                         points[*y_max].y - points[*y_min].y
+                                     ? 0
+                                     : 1;
+
+            const size_t m = lo + (hi - lo) / 2;
+            std::nth_element(order.begin() + lo, order.begin() + m, order.begin() + hi,
+                             [this, axis](size_t a, size_t b) {
+                                 return coordinate(points[a], axis) < coordinate(points[b], axis);
+                             });
+
+            split_axis[m] = axis;
+            n_active[m] = hi - lo;
+
+            build(lo, m);
+            build(m + 1, hi);
+        }
+
+        // Visit every active point of the subtree of [lo, hi), except exclude, that may be nearer
+        // to query than bound(). visit(candidate) is called for each of them.
+        template <typename Bound, typename Visit>
+        void search(size_t lo, size_t hi, const point::point_2D& query, size_t exclude,
+                    const Bound& bound, Visit& visit) const {
+            if (lo >= hi) {
+                return;
+            }
+
+            const size_t m = lo + (hi - lo) / 2;
+            if (n_active[m] == 0) {
+                return;
+            }
+
+            const size_t i = order[m];
+            if (is_active[i] && i != exclude) {
+                visit(candidate_t(squared_distance(query, points[i]), i));
+            }
+
+            // the side of the splitting line that contains the query is searched first
+            const double difference =
+                coordinate(query, split_axis[m]) - coordinate(points[i], split_axis[m]);
+
+            if (difference < 0) {
+                search(lo, m, query, exclude, bound, visit);
+                if (difference * difference <= bound()) {
+                    search(m + 1, hi, query, exclude, bound, visit);
+                }
+            } else {
+                search(m + 1, hi, query, exclude, bound, visit);
+                if (difference * difference <= bound()) {
+                    search(lo, m, query, exclude, bound, visit);
+                }
+            }
+        }
+
+    public:
+        // Build the tree of the points (x[i], y[i]) in O(n log n)
+        KDTree(const std::vector<double>& x, const std::vector<double>& y) :
+            points(x.size()),
+            order(x.size()),
+            position(x.size()),
+            split_axis(x.size()),
+            n_active(x.size()),
+            is_active(x.size(), true) {
+            for (size_t i = 0; i < points.size(); ++i) {
+                points[i] = point::point_2D(x[i], y[i]);
+            }
+
+            std::iota(order.begin(), order.end(), 0);
+            build(0, order.size());
+
+            for (size_t m = 0; m < order.size(); ++m) {
+                position[order[m]] = m;
+            }
+        }
+
+        // Return the number of points that haven't been removed
+        [[nodiscard]] size_t size() const noexcept {
+            return order.empty() ? 0 : n_active[order.size() / 2];
+        }
+
+        // Return the i-th point
+        [[nodiscard]] const point::point_2D& point_at(size_t i) const noexcept {
+            return points[i];
+        }
+
+        // Return true if the i-th point hasn't been removed
+        [[nodiscard]] bool contains(size_t i) const noexcept {
+            return is_active[i];
+        }
+
+        // Remove the i-th point from the following queries, in O(log n)
+        void remove(size_t i) {
+            if (!is_active[i]) {
+                return;
+            }
+
+            is_active[i] = false;
+
+            // update the counters of the nodes from the root to the node of the point
+            size_t lo = 0;
+            size_t hi = order.size();
+            const size_t target = position[i];
+
+            while (true) {
+                const size_t m = lo + (hi - lo) / 2;
+                --n_active[m];
+
+                if (m == target) {
+                    return;
+                }
+
+                if (target < m) {
+                    hi = m;
+                } else {
+                    lo = m + 1;
+                }
+            }
+        }
+
+        // Visit every active point, except exclude, that may be nearer to query than bound().
+        // visit(candidate) is called for each of them.
+        template <typename Bound, typename Visit>
+        void search(const point::point_2D& query, size_t exclude, const Bound& bound,
+                    Visit& visit) const {
+            search(0, order.size(), query, exclude, bound, visit);
+        }
+    };
+}  // namespace spatial
@@ -0,0 +1,139 @@
+#pragma once
+
+#include <algorithm>  // std::push_heap, std::pop_heap, std::sort_heap
+#include <limits>     // std::numeric_limits
+#include <utility>    // std::pair
+#include <vector>     // std::vector
+
+#include "../read_tsp_utils/point.h"
+
+namespace spatial {
+    // Returned by the nearest-point queries when there's no point left
+    constexpr size_t NONE = std::numeric_limits<size_t>::max();
+
+    // (squared distance, point) pair. Candidates are compared by distance first and by index
+    // then, so that the result of every query is deterministic.
+    using candidate_t = std::pair<double, size_t>;
+
+    // Return the squared Euclidean distance between a and b
+    [[nodiscard]] inline double squared_distance(const point::point_2D& a,
+                                                 const point::point_2D& b) noexcept {
+        const double dx = a.x - b.x;
+        const double dy = a.y - b.y;
+        return dx * dx + dy * dy;
+    }
+
+    /**
+     * KNearest keeps the k nearest candidates seen so far in a max-heap, so that the farthest of
+     * them is replaced in O(log k) whenever a nearer candidate is found.
+     */
+    class KNearest {
+        size_t k;
+        std::vector<candidate_t>& heap;
+
+    public:
+        // Use heap, which is cleared, as the storage of the k nearest candidates
+        KNearest(size_t k, std::vector<candidate_t>& heap) : k(k), heap(heap) {
+            heap.clear();
+            heap.reserve(k + 1);
+        }
+
+        // Return true if k candidates have been found
+        [[nodiscard]] bool is_full() const noexcept {
+            return heap.size() == k;
+        }
+
+        // Return the squared distance that a candidate must not exceed to be one of the k nearest.
+        // No candidate can be one of the 0 nearest.
+        [[nodiscard]] double bound() const noexcept {
+            if (k == 0) {
+                return -std::numeric_limits<double>::infinity();
+            }
+
+            return is_full() ? heap.front().first : std::numeric_limits<double>::infinity();
+        }
+
+        // Consider the given candidate
+        void push(const candidate_t& candidate) {
+            if (!is_full()) {
+                heap.push_back(candidate);
+                std::push_heap(heap.begin(), heap.end());
+            } else if (k > 0 && candidate < heap.front()) {
+                std::pop_heap(heap.begin(), heap.end());
+                heap.back() = candidate;
+                std::push_heap(heap.begin(), heap.end());
+            }
+        }
+
+        // Store the points of the k nearest candidates in out, nearest first
+        void get(std::vector<size_t>& out) {
+            std::sort_heap(heap.begin(), heap.end());
+            out.clear();
+
+            for (const auto& [distance, point] : heap) {
+                out.push_back(point);
+            }
+        }
+    };
+
+    /**
+     * The queries below work on any SpatialIndex, i.e. KDTree or BucketGrid, which provides:
+     * - point_at(i): the i-th point;
+     * - search(query, exclude, bound, visit): call visit(candidate) for every point that hasn't
+     *   been removed, except exclude, that may be nearer to query than bound().
+     */
+
+    // Store in out the k points nearest to the i-th point, nearest first. The i-th point itself
+    // and the removed points are skipped. Ties are broken by index.
+    template <class SpatialIndex>
+    void k_nearest(const SpatialIndex& index, size_t i, size_t k, std::vector<size_t>& out) {
+        if (k == 0) {
+            out.clear();
+            return;
+        }
+
+        std::vector<candidate_t> heap;
+        KNearest nearest(k, heap);
+
+        const auto bound = [&nearest]() { return nearest.bound(); };
+        auto visit = [&nearest](const candidate_t& candidate) { nearest.push(candidate); };
+        index.search(index.point_at(i), i, bound, visit);
+
+        nearest.get(out);
+    }
+
+    // Store in out the points whose distance from the i-th point doesn't exceed radius, in no
+    // particular order. The i-th point itself and the removed points are skipped.
+    template <class SpatialIndex>
+    void within_radius(const SpatialIndex& index, size_t i, double radius,
+                       std::vector<size_t>& out) {
+        out.clear();
+
+        const double squared_radius = radius * radius;
+        const auto bound = [squared_radius]() { return squared_radius; };
+        auto visit = [&out, squared_radius](const candidate_t& candidate) {
+            if (candidate.first <= squared_radius) {
+                out.push_back(candidate.second);
+            }
+        };
+        index.search(index.point_at(i), i, bound, visit);
+    }
+
+    // Return the point nearest to the i-th point among the ones that haven't been removed, e.g.
+    // the nearest unvisited city, or NONE if there's none. The i-th point itself is skipped, even
+    // if it hasn't been removed.
+    template <class SpatialIndex>
+    [[nodiscard]] size_t nearest(const SpatialIndex& index, size_t i) {
+        candidate_t best(std::numeric_limits<double>::infinity(), NONE);
+
+        const auto bound = [&best]() { return best.first; };
+        auto visit = [&best](const candidate_t& candidate) {
+            if (candidate < best) {
+                best = candidate;
+            }
+        };
+        index.search(index.point_at(i), i, bound, visit);
+
+        return best.second;
+    }
+}  // namespace spatial
@@ -0,0 +1,315 @@
+#ifndef INDEXED_PRIORITY_QUEUE_H
+#define INDEXED_PRIORITY_QUEUE_H
+
+#include <cassert>      // std::assert
+#include <functional>   // std::greater, std::less
+#include <limits>       // std::numeric_limits
+#include <type_traits>  // std::enable_if
+#include <utility>      // std::pair, std::move
+#include <vector>       // std::vector
+
+namespace priority_queue {
+
+    /**
+     * Priority Queue of the dense integer ids [0, n), based on a D-ary Heap. Unlike PriorityQueue,
+     * the key and the heap position of each id are kept in flat arrays indexed by the id, so no
+     * operation hashes, and the comparator is a template functor that can be inlined rather than
+     * a std::function. No memory is allocated after construction.
+     * Whether it is based on a Min Heap or a Max Heap depends on Compare.
+     * This class shouldn't be invoked directly.
+     * Instead, the factories make_min_indexed_priority_queue and make_max_indexed_priority_queue
+     * should be used.
+     *
+     * Key: type of the keys used to order the Heap.
+     * D: the Heap arity. It must be at least 2.
+     * Compare: comparison functor. Like in heap::Heap, comp(a, b) is true iff the key a must stay
+     *          below the key b in the Heap, thus std::greater<> -> Min Heap and
+     *          std::less<> -> Max Heap.
+     */
+    template <typename Key, std::size_t D = 4, typename Compare = std::greater<>,
+              typename = typename std::enable_if<(D >= 2)>::type>
+    class IndexedPriorityQueue {
+        // position of the ids that aren't in the priority queue
+        static constexpr std::size_t npos = std::numeric_limits<std::size_t>::max();
+
+        // keys[id] -> key assigned to id. It's meaningful only if id is in the priority queue
+        std::vector<Key> keys;
+
+        // ids in the priority queue, in heap order
+        std::vector<std::size_t> nodes;
+
+        // positions[id] -> index in nodes of id, or npos if id isn't in the priority queue
+        std::vector<std::size_t> positions;
+
+        // comparison functor
+        Compare comp;
+
+        // returns the first child of nodes[i]. The others follow it.
+        [[nodiscard]] static std::size_t first_child(const std::size_t i) noexcept {
+            return D * i + 1;
+        }
+
+        // return the parent of nodes[i]
+        [[nodiscard]] static std::size_t parent(const std::size_t i) noexcept {
+            return (i - 1) / D;
+        }
+
+        // move id to nodes[i]
+        void place(const std::size_t i, const std::size_t id) noexcept {
+            nodes[i] = id;
+            positions[id] = i;
+        }
+
+        // starting from a Heap with a misplaced node at the given index,
+        // recover the heap property in O(log_D(N)) bubbling the node up.
+        // Rather than swapping, the node is moved only once it reaches its final position.
+        void heapify_up(const std::size_t index_to_fix) noexcept {
+            const std::size_t id = nodes[index_to_fix];
+            const Key& key = keys[id];
+            std::size_t i = index_to_fix;
+
+            while (i > 0) {
+                const std::size_t p = parent(i);
+                if (!comp(keys[nodes[p]], key)) {
+                    break;
+                }
+
+                place(i, nodes[p]);
+                i = p;
+            }
+
+            place(i, id);
+        }
+
+        // starting from a Heap with a misplaced node at the given index,
+        // recover the heap property in O(D*log_D(N)) bubbling the node down.
+        void heapify_down(const std::size_t index_to_fix) noexcept {
+            const std::size_t len = nodes.size();
+            const std::size_t id = nodes[index_to_fix];
+            const Key& key = keys[id];
+            std::size_t i = index_to_fix;
+
+            while (true) {
+                const std::size_t first = first_child(i);
+                if (first >= len) {
+                    break;
+                }
+
+                // comp_est is the child with the biggest key in a Max Heap,
+                // or the one with the smallest key in a Min Heap
+                const std::size_t last = first + D < len ? first + D : len;
+                std::size_t comp_est = first;
+                for (std::size_t son = first + 1; son < last; ++son) {
+                    if (comp(keys[nodes[comp_est]], keys[nodes[son]])) {
+                        comp_est = son;
+                    }
+                }
+
+                if (!comp(key, keys[nodes[comp_est]])) {
+                    break;
+                }
+
+                place(i, nodes[comp_est]);
+                i = comp_est;
+            }
+
+            place(i, id);
+        }
+
+        // recover the heap property after the key of nodes[i] has changed in either direction
+        void heapify(const std::size_t i) noexcept {
+            if (i > 0 && comp(keys[nodes[parent(i)]], keys[nodes[i]])) {
+                heapify_up(i);
+            } else {
+                heapify_down(i);
+            }
+        }
+
+    public:
+        // disable public default constructor
+        IndexedPriorityQueue() = delete;
+
+        // create an empty priority queue for the ids in [0, n)
+        explicit IndexedPriorityQueue(const std::size_t n, Compare comp = Compare{}) :
+            keys(n), positions(n, npos), comp(std::move(comp)) {
+            nodes.reserve(n);
+        }
+
+        // create a priority queue of every id in [0, n), where n = keys.size(), and keys[id] is
+        // the key of id. The heap is built in O(n).
+        explicit IndexedPriorityQueue(std::vector<Key>&& keys, Compare comp = Compare{}) :
+            keys(std::move(keys)), comp(std::move(comp)) {
+            const std::size_t n = this->keys.size();
+
+            nodes.resize(n);
+            positions.resize(n);
+            for (std::size_t id = 0; id < n; ++id) {
+                place(id, id);
+            }
+
+            for (std::size_t i = n / D + 1; i > 0; --i) {
+                if (i - 1 < n) {
+                    heapify_down(i - 1);
+                }
+            }
+        }
+
+        // return the number of elements in the heap.
+        // Time: O(1).
+        // Space: O(1).
+        [[nodiscard]] std::size_t size() const noexcept {
+            return nodes.size();
+        }
+
+        // return true iff the heap is empty.
+        // Time: O(1).
+        // Space: O(1).
+        [[nodiscard]] bool empty() const noexcept {
+            return nodes.empty();
+        }
+
+        // return n, the number of ids that may be in the priority queue.
+        // Time: O(1).
+        // Space: O(1).
+        [[nodiscard]] std::size_t capacity() const noexcept {
+            return positions.size();
+        }
+
+        // return true iff the given id is in the priority queue.
+        // Time: O(1).
+        // Space: O(1).
+        [[nodiscard]] bool contains(const std::size_t id) const noexcept {
+            return positions[id] != npos;
+        }
+
+        // return the value of the key of the given id, which must be in the priority queue.
+        // Time: O(1).
+        // Space: O(1).
+        [[nodiscard]] const Key& key_at(const std::size_t id) const noexcept {
+            assert(contains(id));
+
+            return keys[id];
+        }
+
+        // add the given id, which mustn't be in the priority queue, and associate the given key
+        // to it.
+        // Time: O(log_D(N)).
+        // Space: O(1).
+        void push(const Key& key, const std::size_t id) noexcept {
+            assert(!contains(id));
+
+            keys[id] = key;
+            nodes.push_back(id);
+            positions[id] = nodes.size() - 1;
+
+            heapify_up(nodes.size() - 1);
+        }
+
+        // update the key of the given id, which must be in the priority queue. The key can either
+        // increase or decrease.
+        // Time: O(log_D(N)) if the id moves towards the top, O(D*log_D(N)) otherwise.
+        // Space: O(1).
+        void update_key(const Key& key, const std::size_t id) noexcept {
+            assert(contains(id));
+
+            keys[id] = key;
+            heapify(positions[id]);
+        }
+
+        // add the given id with the given key if it isn't in the priority queue, or update its key
+        // otherwise.
+        // Time: O(D*log_D(N)).
+        // Space: O(1).
+        void push_or_update(const Key& key, const std::size_t id) noexcept {
+            if (contains(id)) {
+                update_key(key, id);
+            } else {
+                push(key, id);
+            }
+        }
+
+        // return the top id.
+        // Time: O(1).
+        // Space: O(1).
+        [[nodiscard]] std::size_t top() const noexcept {
+            assert(size() > 0);
+
+            return nodes.front();
+        }
+
+        // return top key-id pair.
+        // Time: O(1).
+        // Space: O(1).
+        [[nodiscard]] std::pair<const Key&, std::size_t> top_key_value() const noexcept {
+            const std::size_t top_value = top();
+            return {keys[top_value], top_value};
+        }
+
+        // remove the given id, which must be in the priority queue.
+        // Time: O(D*log_D(N)).
+        // Space: O(1).
+        void erase(const std::size_t id) noexcept {
+            assert(contains(id));
+
+            const std::size_t index_to_remove = positions[id];
+            positions[id] = npos;
+
+            // replace the removed node with the last element of the vector
+            const std::size_t last = nodes.back();
+            nodes.pop_back();
+
+            // no need to recover the heap property if the removed node was the last one
+            if (index_to_remove < nodes.size()) {
+                place(index_to_remove, last);
+                heapify(index_to_remove);
+            }
+        }
+
+        // remove the top id.
+        // Time: O(D*log_D(N)).
+        // Space: O(1).
+        void pop() noexcept {
+            erase(top());
+        }
+
+        // remove every id from the priority queue.
+        // Time: O(N).
+        // Space: O(1).
+        void clear() noexcept {
+            for (const std::size_t id : nodes) {
+                positions[id] = npos;
+            }
+
+            nodes.clear();
+        }
+    };
+
+    // create an empty Indexed Priority Queue of the ids in [0, n) based on a Min D-Heap
+    template <typename Key, std::size_t D = 4>
+    auto make_min_indexed_priority_queue(const std::size_t n) {
+        return IndexedPriorityQueue<Key, D, std::greater<>>(n);
+    }
+
+    // create an Indexed Priority Queue of the ids in [0, keys.size()) based on a Min D-Heap.
+    // It moves the given vector.
+    template <typename Key, std::size_t D = 4>
+    auto make_min_indexed_priority_queue(std::vector<Key>&& keys) {
+        return IndexedPriorityQueue<Key, D, std::greater<>>(std::move(keys));
+    }
+
+    // create an empty Indexed Priority Queue of the ids in [0, n) based on a Max D-Heap
+    template <typename Key, std::size_t D = 4>
+    auto make_max_indexed_priority_queue(const std::size_t n) {
+        return IndexedPriorityQueue<Key, D, std::less<>>(n);
+    }
+
+    // create an Indexed Priority Queue of the ids in [0, keys.size()) based on a Max D-Heap.
+    // It moves the given vector.
+    template <typename Key, std::size_t D = 4>
+    auto make_max_indexed_priority_queue(std::vector<Key>&& keys) {
+        return IndexedPriorityQueue<Key, D, std::less<>>(std::move(keys));
+    }
+
+}  // namespace priority_queue
+
+#endif  // INDEXED_PRIORITY_QUEUE_H
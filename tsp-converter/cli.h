@@ -0,0 +1,51 @@
+#pragma once
+
+#include <argparse/include/argparse/argparse.hpp>
+#include <shared/DistanceMatrix.h>
+#include <iostream>   // std::cout
+#include <stdexcept>  // std::runtime_error
+#include <string>     // std::string, std::string_literals
+
+namespace cli {
+    struct CLIArgs : public argparse::Args {
+        std::string& filename = kwarg("f,filename", "Name of the TSP instance file");
+
+        std::string& output = kwarg("o,output", "Name of the binary instance file to create");
+
+        bool& matrix =
+            flag("m,matrix", "Store the precomputed distance matrix").set_default(false);
+
+        std::string& distance_type =
+            kwarg("d,distance-type", "Type of the stored distances: double, int32, uint16")
+                .set_default("double");
+
+        std::string& distance_layout =
+            kwarg("distance-layout", "Storage of the stored distance matrix: full, packed")
+                .set_default("full");
+
+        unsigned int& neighbors =
+            kwarg("neighbors", "Size of the stored candidate lists, 0 to skip them")
+                .set_default(0u);
+
+        // Show introductory message to the users
+        void welcome() override {
+            std::cout << "TSPLIB to binary instance converter\n";
+        }
+    };
+
+    CLIArgs parse(int argc, char** argv) {
+        return argparse::parse<CLIArgs>(argc, argv);
+    }
+
+    // Convert the name of a distance matrix storage layout to its DistanceMatrixLayout value
+    DistanceMatrixLayout parse_distance_layout(const std::string& name) {
+        if (name == "full") {
+            return DistanceMatrixLayout::FULL;
+        } else if (name == "packed") {
+            return DistanceMatrixLayout::PACKED;
+        }
+
+        using namespace std::string_literals;
+        throw std::runtime_error("Unsupported distance matrix layout: "s + name);
+    }
+}  // namespace cli
@@ -0,0 +1,66 @@
+#include <iostream>  // std::cerr, std::cout
+#include <optional>  // std::optional
+
+#include <shared/CoordinateDistances.h>
+#include <shared/DistanceMatrix.h>
+#include <shared/DistanceType.h>
+#include <shared/Distances.h>
+#include <shared/NeighborLists.h>
+#include <shared/read_tsp_file.h>
+#include <shared/read_tsp_utils/EdgeWeightType.h>
+#include <shared/stopwatch.h>
+
+#include "cli.h"
+
+// Convert the TSP instance read by point_reader to a binary instance, storing distances of type T
+template <typename T>
+void convert(const cli::CLIArgs& args, const point_reader::PointReader& point_reader) {
+    const auto program_time_start = stopwatch::now();
+
+    std::optional<DistanceMatrix<T>> distance_matrix;
+    if (args.matrix) {
+        distance_matrix.emplace(point_reader.create_distance_matrix<T>(
+            cli::parse_distance_layout(args.distance_layout)));
+    }
+
+    std::optional<NeighborLists> neighbor_lists;
+    if (args.neighbors > 0) {
+        const CoordinateDistances<T> coordinate_distances =
+            point_reader.create_coordinate_distances<T>();
+        neighbor_lists.emplace(
+            point_reader.create_neighbor_lists<T>(coordinate_distances, args.neighbors));
+    }
+
+    point_reader.write_binary_instance<T>(args.output.c_str(),
+                                          distance_matrix ? &*distance_matrix : nullptr,
+                                          neighbor_lists ? &*neighbor_lists : nullptr);
+
+    const auto program_time_stop = stopwatch::now();
+
+    // executions of the program in ms
+    const auto program_time_ms =
+        stopwatch::duration<stopwatch::ms_t>(program_time_start, program_time_stop);
+
+    std::cout << "N: " << point_reader.dimension << '\n';
+    std::cout << "program_time_ms: " << program_time_ms << '\n';
+    std::cout << std::flush;
+}
+
+int main(int argc, char** argv) {
+    /**
+     * Handler for command-line arguments
+     */
+    auto args = cli::parse(argc, argv);
+
+    auto point_reader(read_tsp_file(args.filename.c_str()));
+
+    // binary instances always store the coordinates, which EXPLICIT instances don't have
+    if (point_reader->edge_weight_type() == EdgeWeightType::EXPLICIT) {
+        std::cerr << "EXPLICIT instances can't be converted to binary instances\n";
+        return 1;
+    }
+
+    // instantiate the converter with the distance type chosen by the user
+    visit_distance_type(parse_distance_type(args.distance_type),
+                        [&](auto distance) { convert<decltype(distance)>(args, *point_reader); });
+}